@@ -0,0 +1,276 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include "nim_ai.h"
+
+/*
+ * Job lifecycle:
+ * nim_ai_post() copies the position into the 'pending' job and
+ * bumps 'posted'. The worker swaps 'pending' and 'running', so
+ * that a new post never touches the position being searched, and
+ * once done, only publishes the result if no other job was posted
+ * (or canceled) in the meantime. nim_ai_poll() consumes it.
+ */
+
+#if NIM_AI_THREADS
+	#define LOCK(ai)   pthread_mutex_lock(&(ai)->mutex)
+	#define UNLOCK(ai) pthread_mutex_unlock(&(ai)->mutex)
+#else
+	#define LOCK(ai)
+	#define UNLOCK(ai)
+#endif
+
+/**
+ * Copy the position @p pos into the job @p job.
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+static int job_set(struct nim_ai_job *job, const struct nim_position *pos,
+	nim_ai_think think, void *arg)
+{
+	uint64_t *heaps;
+
+	if (pos->nheaps > job->cap)
+	{
+		if (!(heaps = realloc(job->heaps, pos->nheaps * sizeof(*heaps))))
+			return (-1);
+		job->heaps = heaps;
+		job->cap   = pos->nheaps;
+	}
+
+	if (pos->nheaps)
+		memcpy(job->heaps, pos->heaps, pos->nheaps * sizeof(*job->heaps));
+
+	job->pos.heaps  = job->heaps;
+	job->pos.nheaps = pos->nheaps;
+	job->think = think;
+	job->arg   = arg;
+	return (0);
+}
+
+/**
+ * Run the job @p job (with id @p id) and publish its result, if
+ * still wanted.
+ */
+static void job_run(struct nim_ai *ai, struct nim_ai_job *job, unsigned id)
+{
+	struct nim_move move;
+	int ret;
+
+	ret = job->think(&job->pos, &move, job->arg);
+
+	LOCK(ai);
+		if (id == ai->posted)
+		{
+			ai->result    = ret;
+			ai->move      = move;
+			ai->available = 1;
+		}
+	UNLOCK(ai);
+}
+
+#if NIM_AI_THREADS
+/**
+ * Worker thread routine.
+ */
+static void *worker(void *arg)
+{
+	struct nim_ai *ai = arg;
+	struct nim_ai_job *job;
+	unsigned id;
+
+	for (;;)
+	{
+		LOCK(ai);
+			ai->is_running = 0;
+			while (!ai->has_pending && !ai->quit)
+				pthread_cond_wait(&ai->cond, &ai->mutex);
+
+			if (ai->quit)
+			{
+				UNLOCK(ai);
+				break;
+			}
+
+			job = ai->pending;
+			ai->pending = ai->running;
+			ai->running = job;
+			ai->has_pending = 0;
+			ai->is_running  = 1;
+			ai->running_id  = ai->posted;
+			id = ai->posted;
+		UNLOCK(ai);
+
+		job_run(ai, job, id);
+	}
+	return (NULL);
+}
+#endif
+
+/**
+ * Initialize the AI worker @p ai.
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+int nim_ai_init(struct nim_ai *ai)
+{
+	memset(ai, 0, sizeof(*ai));
+	ai->pending = &ai->jobs[0];
+	ai->running = &ai->jobs[1];
+
+#if NIM_AI_THREADS
+	if (pthread_mutex_init(&ai->mutex, NULL))
+		return (-1);
+	if (pthread_cond_init(&ai->cond, NULL))
+	{
+		pthread_mutex_destroy(&ai->mutex);
+		return (-1);
+	}
+	if (pthread_create(&ai->thread, NULL, worker, ai))
+	{
+		pthread_cond_destroy(&ai->cond);
+		pthread_mutex_destroy(&ai->mutex);
+		return (-1);
+	}
+#endif
+	return (0);
+}
+
+/**
+ * Stop the worker of @p ai (waiting for the current job) and
+ * release its resources.
+ */
+void nim_ai_finish(struct nim_ai *ai)
+{
+#if NIM_AI_THREADS
+	LOCK(ai);
+		ai->posted++;
+		ai->quit = 1;
+		pthread_cond_signal(&ai->cond);
+	UNLOCK(ai);
+
+	pthread_join(ai->thread, NULL);
+	pthread_cond_destroy(&ai->cond);
+	pthread_mutex_destroy(&ai->mutex);
+#endif
+	free(ai->jobs[0].heaps);
+	free(ai->jobs[1].heaps);
+	memset(ai, 0, sizeof(*ai));
+}
+
+/**
+ * Post a new job: choose a move for @p pos with @p think. Any
+ * previous job is discarded.
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+int nim_ai_post(struct nim_ai *ai, const struct nim_position *pos,
+	nim_ai_think think, void *arg)
+{
+	int ret;
+
+	LOCK(ai);
+		ai->posted++;
+		ai->available = 0;
+		ret = job_set(ai->pending, pos, think, arg);
+		ai->has_pending = (ret == 0);
+#if NIM_AI_THREADS
+		if (!ret)
+			pthread_cond_signal(&ai->cond);
+#endif
+	UNLOCK(ai);
+
+#if !NIM_AI_THREADS
+	/* No threads: synchronous fallback. */
+	if (!ret)
+	{
+		ai->has_pending = 0;
+		ai->running_id  = ai->posted;
+		job_run(ai, ai->pending, ai->posted);
+	}
+#endif
+	return (ret);
+}
+
+/**
+ * Poll the current job; if finished, its move is saved into
+ * @p move and the job is consumed.
+ *
+ * Returns one of the NIM_AI_* values.
+ */
+int nim_ai_poll(struct nim_ai *ai, struct nim_move *move)
+{
+	int ret;
+
+	LOCK(ai);
+		if (ai->available)
+		{
+			ai->available = 0;
+			ret = NIM_AI_NO_MOVE;
+			if (!ai->result)
+			{
+				*move = ai->move;
+				ret   = NIM_AI_DONE;
+			}
+		}
+		else if (ai->has_pending ||
+			(ai->is_running && ai->running_id == ai->posted))
+		{
+			ret = NIM_AI_BUSY;
+		}
+		else
+			ret = NIM_AI_IDLE;
+	UNLOCK(ai);
+	return (ret);
+}
+
+/**
+ * Cancel the current job (if any): its result, if any, is
+ * discarded.
+ */
+void nim_ai_cancel(struct nim_ai *ai)
+{
+	LOCK(ai);
+		ai->posted++;
+		ai->has_pending = 0;
+		ai->available   = 0;
+	UNLOCK(ai);
+}
+
+/**
+ * Returns 1 if the job running on @p ai was canceled or replaced,
+ * 0 otherwise. Meant to be called by think routines.
+ */
+int nim_ai_cancelled(struct nim_ai *ai)
+{
+	int ret;
+
+	LOCK(ai);
+		ret = (ai->running_id != ai->posted);
+	UNLOCK(ai);
+	return (ret);
+}
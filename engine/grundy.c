@@ -0,0 +1,434 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "nim_sg.h"
+#include "kernels.h"
+
+/* Interval (in values) between period checks. */
+#define CHECK_INTERVAL 64
+
+/* ---------------------------------------------------------------------- */
+/* Values computation.                                                    */
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Scratch used by the mex computation: seen[v] == stamp means
+ * that the value v is an option of the current heap.
+ */
+struct mex
+{
+	uint32_t *seen;
+	size_t cap;
+	uint32_t stamp;
+};
+
+/**
+ * Mark the value @p v as seen.
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+static int mark(struct mex *m, uint64_t v)
+{
+	uint32_t *seen;
+	size_t cap;
+
+	if (v >= m->cap)
+	{
+		cap = m->cap ? m->cap : 64;
+		while (cap <= v)
+			cap <<= 1;
+
+		if (!(seen = realloc(m->seen, cap * sizeof(*seen))))
+			return (-1);
+
+		memset(seen + m->cap, 0, (cap - m->cap) * sizeof(*seen));
+		m->seen = seen;
+		m->cap  = cap;
+	}
+
+	m->seen[v] = m->stamp;
+	return (0);
+}
+
+/**
+ * Compute g(n), given that all the previous values are already
+ * known.
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+static int compute(struct nim_sg *sg, struct mex *m, size_t n)
+{
+	const uint64_t *g;
+	uint64_t v;
+	size_t k;
+	size_t a;
+	int d;
+
+	g = sg->values;
+
+	/* New stamp, clear on wrap around. */
+	if (!++m->stamp)
+	{
+		memset(m->seen, 0, m->cap * sizeof(*m->seen));
+		m->stamp = 1;
+	}
+
+	for (k = 1; k <= sg->ndigits && k <= n; k++)
+	{
+		d = sg->digits[k];
+
+		if ((d & 1) && n == k && mark(m, 0) < 0)
+			return (-1);
+		if ((d & 2) && n > k && mark(m, g[n - k]) < 0)
+			return (-1);
+		if (d & 4)
+			for (a = 1; a <= (n - k) / 2 && n - k - a > 0; a++)
+				if (mark(m, g[a] ^ g[n - k - a]) < 0)
+					return (-1);
+	}
+
+	/* Minimum excluded value. */
+	for (v = 0; v < m->cap && m->seen[v] == m->stamp; v++);
+	sg->values[n] = v;
+	return (0);
+}
+
+/**
+ * Look for a period in the values computed so far.
+ *
+ * By the Guy-Smith periodicity theorem, if g(n + p) = g(n) for
+ * all e <= n < 2e + p + t, being t the biggest amount that can be
+ * removed, then g(n + p) = g(n) for all n >= e.
+ *
+ * Returns 1 if found, 0 otherwise.
+ */
+static int find_period(struct nim_sg *sg)
+{
+	const uint64_t *g;
+	size_t e;
+	size_t p;
+	size_t n;
+
+	g = sg->values;
+	n = sg->count;
+
+	for (p = 1; p <= n / 2; p++)
+	{
+		/* Smallest e with g(m + p) = g(m) for every e <= m < n - p. */
+		for (e = n - p; e > 0 && g[e - 1 + p] == g[e - 1]; e--);
+
+		if (2 * e + 2 * p + sg->ndigits <= n)
+		{
+			sg->preperiod = e;
+			sg->period    = p;
+			return (1);
+		}
+	}
+	return (0);
+}
+
+/**
+ * Compute the values of @p sg until a period is found or @p limit
+ * values are known.
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+static int solve(struct nim_sg *sg, size_t limit)
+{
+	struct mex m = {0};
+	size_t n;
+	int ret;
+
+	if (!limit)
+		limit = NIM_SG_DEFAULT_LIMIT;
+
+	if (!(sg->values = malloc(limit * sizeof(*sg->values))))
+		return (-1);
+
+	ret = 0;
+	for (n = 0; n < limit; n++)
+	{
+		if ((ret = compute(sg, &m, n)) < 0)
+			break;
+
+		sg->count = n + 1;
+		if (!(sg->count % CHECK_INTERVAL) && find_period(sg))
+			break;
+	}
+
+	if (!ret && !sg->period)
+		find_period(sg);
+
+	free(m.seen);
+	if (ret < 0)
+		nim_sg_free(sg);
+	return (ret);
+}
+
+/* ---------------------------------------------------------------------- */
+/* Initialization.                                                        */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Initialize @p sg with the octal game @p code (such as "0.137"),
+ * computing up to @p limit values (or NIM_SG_DEFAULT_LIMIT if 0)
+ * while looking for a period.
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+int nim_sg_init_octal(struct nim_sg *sg, const char *code, size_t limit)
+{
+	memset(sg, 0, sizeof(*sg));
+
+	/* Only '0.' games, i.e: at least one element must be removed. */
+	if (*code == '0')
+		code++;
+	if (*code++ != '.')
+		return (-1);
+
+	for (; *code; code++)
+	{
+		if (*code < '0' || *code > '7' || sg->ndigits == NIM_SG_MAX_DIGITS)
+			return (-1);
+		sg->digits[++sg->ndigits] = (uint8_t)(*code - '0');
+	}
+
+	/* Drop trailing zeros: they do not change the game. */
+	while (sg->ndigits && !sg->digits[sg->ndigits])
+		sg->ndigits--;
+
+	if (!sg->ndigits)
+		return (-1);
+
+	return (solve(sg, limit));
+}
+
+/**
+ * Initialize @p sg with the subtraction game whose set of amounts
+ * that can be removed is @p set.
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+int nim_sg_init_subtraction(struct nim_sg *sg, const uint64_t *set,
+	size_t nset, size_t limit)
+{
+	size_t i;
+
+	memset(sg, 0, sizeof(*sg));
+
+	for (i = 0; i < nset; i++)
+	{
+		if (!set[i] || set[i] > NIM_SG_MAX_DIGITS)
+			return (-1);
+
+		sg->digits[set[i]] = 3;
+		if (set[i] > sg->ndigits)
+			sg->ndigits = (size_t)set[i];
+	}
+
+	if (!sg->ndigits)
+		return (-1);
+
+	return (solve(sg, limit));
+}
+
+/**
+ * Initialize @p sg as plain Nim, i.e: g(n) = n.
+ */
+void nim_sg_init_nim(struct nim_sg *sg)
+{
+	memset(sg, 0, sizeof(*sg));
+	sg->nim = 1;
+}
+
+/**
+ * Release the memoized values of @p sg.
+ */
+void nim_sg_free(struct nim_sg *sg)
+{
+	free(sg->values);
+	sg->values = NULL;
+	sg->count  = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+/* Queries.                                                               */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Get the Grundy value of a heap of size @p heap.
+ *
+ * Returns 0 if success, -1 if @p heap is beyond the computed
+ * values and the game is not known to be periodic.
+ */
+int nim_sg_value(const struct nim_sg *sg, uint64_t heap, uint64_t *value)
+{
+	if (sg->nim)
+	{
+		*value = heap;
+		return (0);
+	}
+
+	if (sg->period && heap >= sg->preperiod)
+		heap = sg->preperiod + (heap - sg->preperiod) % sg->period;
+
+	if (heap >= sg->count)
+		return (-1);
+
+	*value = sg->values[heap];
+	return (0);
+}
+
+/**
+ * Compute the Grundy value of the position @p pos, i.e: the xor
+ * of the values of all heaps, which are saved into @p scratch
+ * (with room for pos->nheaps values).
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+int nim_sg_position_value(const struct nim_sg *sg,
+	const struct nim_position *pos, uint64_t *scratch, uint64_t *value)
+{
+	size_t i;
+
+	for (i = 0; i < pos->nheaps; i++)
+		if (nim_sg_value(sg, pos->heaps[i], &scratch[i]) < 0)
+			return (-1);
+
+	*value = nim_kernels.xor_reduce(scratch, pos->nheaps);
+	return (0);
+}
+
+/**
+ * Look for a move in a heap of size @p heap: the first one that
+ * leads to the value @p target, or the first legal one if
+ * @p any is set.
+ *
+ * Returns 0 if found, -1 otherwise.
+ */
+static int find_option(const struct nim_sg *sg, uint64_t heap,
+	uint64_t target, int any, struct nim_sg_move *move)
+{
+	uint64_t bound;
+	uint64_t va;
+	uint64_t vb;
+	uint64_t v;
+	uint64_t a;
+	size_t k;
+	int d;
+
+	for (k = 1; k <= sg->ndigits && k <= heap; k++)
+	{
+		d = sg->digits[k];
+		move->amount = k;
+		move->left   = 0;
+
+		if ((d & 1) && heap == k && (any || !target))
+			return (0);
+		if ((d & 2) && heap > k && (any ||
+			(!nim_sg_value(sg, heap - k, &v) && v == target)))
+		{
+			return (0);
+		}
+
+		if (!(d & 4) || heap < k + 2)
+			continue;
+
+		/*
+		 * Splits: if periodic, the pairs (a, heap-k-a) for bigger
+		 * 'a' repeat the values of the smaller ones.
+		 */
+		bound = (heap - k) / 2;
+		if (sg->period && bound > sg->preperiod + sg->period)
+			bound = sg->preperiod + sg->period;
+
+		for (a = 1; a <= bound; a++)
+		{
+			if (nim_sg_value(sg, a, &va) < 0 ||
+				nim_sg_value(sg, heap - k - a, &vb) < 0)
+			{
+				return (-1);
+			}
+
+			if (any || (va ^ vb) == target)
+			{
+				move->left = a;
+				return (0);
+			}
+		}
+	}
+	return (-1);
+}
+
+/**
+ * Choose the best move for the position @p pos (normal play):
+ * a move to a position of value 0 if there is one, otherwise,
+ * the first legal move. @p scratch must have room for
+ * pos->nheaps values.
+ *
+ * Returns 0 if success, -1 if there is no move left or the
+ * values could not be computed.
+ */
+int nim_sg_best_move(const struct nim_sg *sg,
+	const struct nim_position *pos, uint64_t *scratch,
+	struct nim_sg_move *move)
+{
+	uint64_t total;
+	size_t i;
+
+	if (nim_sg_position_value(sg, pos, scratch, &total) < 0)
+		return (-1);
+
+	/* Winning: same search as in Nim, but over the Grundy values. */
+	if (total)
+	{
+		i = nim_kernels.find_winning(scratch, pos->nheaps, total);
+		move->heap = i;
+
+		if (sg->nim)
+		{
+			move->amount = pos->heaps[i] - (scratch[i] ^ total);
+			move->left   = 0;
+			return (0);
+		}
+		return (find_option(sg, pos->heaps[i], scratch[i] ^ total, 0, move));
+	}
+
+	/* Losing: any legal move. */
+	for (i = 0; i < pos->nheaps; i++)
+	{
+		move->heap = i;
+		if (sg->nim && pos->heaps[i])
+		{
+			move->amount = 1;
+			move->left   = 0;
+			return (0);
+		}
+		if (!sg->nim && !find_option(sg, pos->heaps[i], 0, 1, move))
+			return (0);
+	}
+	return (-1);
+}
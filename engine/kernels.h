@@ -0,0 +1,52 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+	#include <stddef.h>
+	#include <stdint.h>
+
+	/*
+	 * Engine-internal heap kernels: these are the three linear
+	 * passes done by the solver over the heaps, selected at
+	 * runtime accordingly with the instruction set supported
+	 * by the CPU (see simd.c).
+	 */
+	struct nim_kernels
+	{
+		/* Xor of all heaps. */
+		uint64_t (*xor_reduce)(const uint64_t *heaps, size_t n);
+
+		/* Amount of heaps with more than one element. */
+		size_t (*count_gt_one)(const uint64_t *heaps, size_t n);
+
+		/* First heap i where heaps[i] ^ nim < heaps[i], or n. */
+		size_t (*find_winning)(const uint64_t *heaps, size_t n,
+			uint64_t nim);
+	};
+
+	extern struct nim_kernels nim_kernels;
+
+#endif /* KERNELS_H. */
@@ -0,0 +1,619 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "nim_mcts.h"
+
+/*
+ * Node statistics are kept from the point of view of the player
+ * that did the move leading to the node (the 'mover').
+ *
+ * Proven results are also kept in a transposition table, indexed
+ * by an order-independent hash of the heaps, so that a position
+ * solved in one branch is not searched again in the others. The
+ * entries are stamped with the search generation, and the ones of
+ * the previous searches are ignored (instead of clearing the table
+ * each time), so the strength depends only on the budget.
+ */
+
+/* Proven results, for the mover. */
+#define PROVEN_NONE  0
+#define PROVEN_WIN   1
+#define PROVEN_LOSS -1
+
+/* No node. */
+#define NIL UINT32_MAX
+
+/* Exploration constant. */
+#define UCT_C 1.4142135f
+
+/*
+ * Progressive widening: a node gets at most PW_K * sqrt(visits + 1)
+ * children, each one a random untried move, so that the search
+ * spreads over all the heaps even when the moves are too many to
+ * be all expanded.
+ */
+#define PW_K 2.0f
+
+/* Iterations between budget/cancellation checks. */
+#define CHECK_INTERVAL 64
+
+/*
+ * Tree node.
+ */
+struct mcts_node
+{
+	struct nim_move move;  /* Move leading to this node.       */
+	uint64_t key;          /* Position hash.                   */
+	uint64_t moves;        /* Legal moves (saturated), 0: n/a. */
+	uint32_t parent;
+	uint32_t child;
+	uint32_t sibling;
+	uint32_t visits;
+	uint32_t children;
+	float wins;
+	int8_t proven;
+	uint8_t expanded;      /* All children created.            */
+};
+
+/*
+ * Transposition table entry: proven result for the player that
+ * moved into the position.
+ */
+struct mcts_entry
+{
+	uint64_t key;
+	int32_t proven;
+	uint32_t generation;   /* Search that stored it.       */
+};
+
+/* Difficulty budgets. */
+static const struct nim_mcts_budget levels[NIM_MCTS_LEVELS] = {
+	{    50, 0.0   },  /* Easy.   */
+	{  1500, 0.0   },  /* Medium. */
+	{     0, 0.008 },  /* Hard: half a frame at 60 FPS. */
+};
+
+/* ---------------------------------------------------------------------- */
+/* Helpers.                                                               */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Hash of a single heap: splitmix64 finalizer, 0 for empty heaps.
+ * The position hash is the sum over all heaps.
+ */
+static inline uint64_t heap_hash(uint64_t h)
+{
+	if (!h)
+		return (0);
+	h += 0x9E3779B97F4A7C15ULL;
+	h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+	return (h ^ (h >> 31));
+}
+
+/**
+ * Hash of the position @p heaps after the move @p move.
+ */
+static inline uint64_t child_key(uint64_t key, const uint64_t *heaps,
+	const struct nim_move *move)
+{
+	return (key - heap_hash(heaps[move->heap]) +
+		heap_hash(heaps[move->heap] - move->amount));
+}
+
+/**
+ * Store the proven result of @p node in the transposition table.
+ */
+static inline void table_store(struct nim_mcts *mcts, const struct mcts_node *n)
+{
+	struct mcts_entry *e;
+	e = &mcts->table[n->key & mcts->table_mask];
+	e->key = n->key;
+	e->proven = n->proven;
+	e->generation = mcts->generation;
+}
+
+/**
+ * Lookup the position hash @p key in the transposition table.
+ *
+ * Returns the proven result, or PROVEN_NONE if not found.
+ */
+static inline int table_probe(struct nim_mcts *mcts, uint64_t key)
+{
+	struct mcts_entry *e;
+	e = &mcts->table[key & mcts->table_mask];
+	if (e->key != key || e->generation != mcts->generation)
+		return (PROVEN_NONE);
+	return ((int)e->proven);
+}
+
+/**
+ * Returns the current monotonic time, in seconds.
+ */
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((double)ts.tv_sec + (double)ts.tv_nsec * 1e-9);
+}
+
+/**
+ * Allocate a new node, child of @p parent.
+ *
+ * Returns the node index, or NIL if the arena is full.
+ */
+static uint32_t new_node(struct nim_mcts *mcts, uint32_t parent,
+	const struct nim_move *move)
+{
+	struct mcts_node *n;
+	uint32_t idx;
+
+	if (mcts->count == mcts->max_nodes)
+		return (NIL);
+
+	idx = (uint32_t)mcts->count++;
+	n = &mcts->nodes[idx];
+	memset(n, 0, sizeof(*n));
+	n->parent  = parent;
+	n->child   = NIL;
+	n->sibling = NIL;
+	if (move)
+		n->move = *move;
+
+	if (parent != NIL)
+	{
+		n->sibling = mcts->nodes[parent].child;
+		mcts->nodes[parent].child = idx;
+	}
+	return (idx);
+}
+
+/**
+ * Returns true if the node @p n may get a new child, see PW_K.
+ */
+static inline int can_widen(const struct mcts_node *n)
+{
+	return (!n->expanded &&
+		(float)n->children < PW_K * sqrtf((float)n->visits + 1.0f));
+}
+
+/**
+ * Returns the amount of legal moves in @p pos, saturated.
+ */
+static uint64_t count_moves(const struct nim_position *pos)
+{
+	uint64_t moves = 0;
+	size_t h;
+
+	for (h = 0; h < pos->nheaps; h++)
+	{
+		if (moves + pos->heaps[h] < moves)
+			return (UINT64_MAX);
+		moves += pos->heaps[h];
+	}
+	return (moves);
+}
+
+/**
+ * Pick a uniformly random move of @p pos not yet expanded from
+ * @p node: if already there, the next untried one, in (heap,
+ * amount) order.
+ */
+static void random_untried_move(struct nim_mcts *mcts, uint32_t node,
+	const struct nim_position *pos, struct nim_move *move)
+{
+	struct mcts_node *c;
+	uint64_t r;
+	uint32_t i;
+	size_t h;
+
+	r = nim_rand_range(&mcts->rng, 0, mcts->nodes[node].moves - 1);
+	for (h = 0; r >= pos->heaps[h]; h++)
+		r -= pos->heaps[h];
+
+	move->heap   = h;
+	move->amount = r + 1;
+
+	/* Already tried: the next one, and check again. */
+	i = mcts->nodes[node].child;
+	while (i != NIL)
+	{
+		c = &mcts->nodes[i];
+		if (c->move.heap == move->heap && c->move.amount == move->amount)
+		{
+			if (nim_next_move(pos, move) < 0)
+				nim_first_move(pos, move);
+			i = mcts->nodes[node].child;
+		}
+		else
+			i = c->sibling;
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+/* Search steps.                                                          */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Selection: choose the child of @p node with the best UCT score,
+ * ignoring proven losses.
+ *
+ * Returns the child index, or NIL if all are proven losses.
+ */
+static uint32_t select_child(struct nim_mcts *mcts, uint32_t node)
+{
+	struct mcts_node *c;
+	float log_visits;
+	float best_score;
+	float score;
+	uint32_t best;
+	uint32_t i;
+
+	log_visits = logf((float)mcts->nodes[node].visits + 1.0f);
+	best_score = -1.0f;
+	best = NIL;
+
+	for (i = mcts->nodes[node].child; i != NIL; i = c->sibling)
+	{
+		c = &mcts->nodes[i];
+		if (c->proven == PROVEN_LOSS)
+			continue;
+		if (c->proven == PROVEN_WIN)
+			return (i);
+
+		score = c->wins / (float)c->visits +
+			UCT_C * sqrtf(log_visits / (float)c->visits);
+
+		if (score > best_score)
+		{
+			best_score = score;
+			best = i;
+		}
+	}
+	return (best);
+}
+
+/**
+ * Rollout: play random moves on the scratch heaps until the game
+ * is over.
+ *
+ * Returns 1 if the player to move at the start loses (i.e: takes
+ * the last element), 0 otherwise.
+ */
+static int rollout(struct nim_mcts *mcts, size_t nheaps)
+{
+	uint64_t amount;
+	size_t count;
+	size_t slot;
+	size_t h;
+	int turn;
+
+	count = 0;
+	for (h = 0; h < nheaps; h++)
+		if (mcts->heaps[h])
+			mcts->nonempty[count++] = h;
+
+	for (turn = 0; ; turn = !turn)
+	{
+		slot   = (size_t)nim_rand_range(&mcts->rng, 0, count - 1);
+		h      = mcts->nonempty[slot];
+		amount = nim_rand_range(&mcts->rng, 1, mcts->heaps[h]);
+
+		mcts->heaps[h] -= amount;
+		if (!mcts->heaps[h])
+		{
+			mcts->nonempty[slot] = mcts->nonempty[--count];
+			if (!count)
+				return (turn == 0);
+		}
+	}
+}
+
+/**
+ * Propagate a proven result at @p node to its parent (and so on),
+ * MCTS-Solver style.
+ */
+static void propagate_proof(struct nim_mcts *mcts, uint32_t node)
+{
+	struct mcts_node *parent;
+	uint32_t i;
+
+	while (mcts->nodes[node].parent != NIL)
+	{
+		parent = &mcts->nodes[mcts->nodes[node].parent];
+		if (parent->proven)
+			return;
+
+		/* The opponent has a winning reply: the parent move loses. */
+		if (mcts->nodes[node].proven == PROVEN_WIN)
+			parent->proven = PROVEN_LOSS;
+
+		/* All replies lose: the parent move wins. */
+		else
+		{
+			if (!parent->expanded)
+				return;
+			for (i = parent->child; i != NIL; i = mcts->nodes[i].sibling)
+				if (mcts->nodes[i].proven != PROVEN_LOSS)
+					return;
+			parent->proven = PROVEN_WIN;
+		}
+
+		table_store(mcts, parent);
+
+		node = mcts->nodes[node].parent;
+	}
+}
+
+/**
+ * Single MCTS iteration, from the root position @p root.
+ */
+static void iterate(struct nim_mcts *mcts, const struct nim_position *root)
+{
+	struct nim_position pos;
+	struct nim_move move;
+	struct mcts_node *n;
+	struct mcts_node *c;
+	uint32_t node;
+	uint32_t next;
+	int mover_lost;
+
+	memcpy(mcts->heaps, root->heaps, root->nheaps * sizeof(*mcts->heaps));
+	pos.heaps  = mcts->heaps;
+	pos.nheaps = root->nheaps;
+	node = 0;
+
+	/* Selection: down to a node that can still widen. */
+	while (!mcts->nodes[node].proven && !can_widen(&mcts->nodes[node]))
+	{
+		if ((next = select_child(mcts, node)) == NIL)
+			break;
+		node = next;
+		mcts->heaps[mcts->nodes[node].move.heap] -=
+			mcts->nodes[node].move.amount;
+	}
+
+	/*
+	 * Expansion: also when all the children so far are proven
+	 * losses, whatever the widening.
+	 */
+	n = &mcts->nodes[node];
+	if (!n->proven && !n->expanded)
+	{
+		if (!n->moves)
+			n->moves = count_moves(&pos);
+
+		random_untried_move(mcts, node, &pos, &move);
+		if ((next = new_node(mcts, node, &move)) != NIL)
+		{
+			n = &mcts->nodes[node];
+			c = &mcts->nodes[next];
+			c->key = child_key(n->key, mcts->heaps, &c->move);
+			if (++n->children == n->moves)
+				n->expanded = 1;
+
+			node = next;
+			mcts->heaps[c->move.heap] -= c->move.amount;
+
+			/* Terminal: the mover took the last element and loses. */
+			if (nim_is_over(&pos))
+				c->proven = PROVEN_LOSS;
+			else
+				c->proven = (int8_t)table_probe(mcts, c->key);
+
+			if (c->proven)
+				propagate_proof(mcts, node);
+		}
+	}
+
+	n = &mcts->nodes[node];
+	if (n->proven)
+		mover_lost = (n->proven == PROVEN_LOSS);
+
+	/* Simulation: the mover wins if the opponent takes the last one. */
+	else
+		mover_lost = !rollout(mcts, pos.nheaps);
+
+	/* Backpropagation. */
+	for (;;)
+	{
+		n = &mcts->nodes[node];
+		n->visits++;
+		n->wins += mover_lost ? 0.0f : 1.0f;
+		if (n->parent == NIL)
+			break;
+		node = n->parent;
+		mover_lost = !mover_lost;
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+/* Public routines.                                                       */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Initialize the MCTS opponent @p mcts with an arena of
+ * @p max_nodes nodes (or NIM_MCTS_DEFAULT_NODES if 0).
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+int nim_mcts_init(struct nim_mcts *mcts, size_t max_nodes, uint64_t seed)
+{
+	memset(mcts, 0, sizeof(*mcts));
+
+	if (!max_nodes)
+		max_nodes = NIM_MCTS_DEFAULT_NODES;
+	if (max_nodes >= NIL)
+		return (-1);
+
+	mcts->nodes = malloc(max_nodes * sizeof(*mcts->nodes));
+	mcts->table = calloc(NIM_MCTS_TABLE_SIZE, sizeof(*mcts->table));
+	if (!mcts->nodes || !mcts->table)
+	{
+		nim_mcts_free(mcts);
+		return (-1);
+	}
+
+	mcts->max_nodes  = max_nodes;
+	mcts->table_mask = NIM_MCTS_TABLE_SIZE - 1;
+	nim_rand_seed(&mcts->rng, seed);
+	nim_mcts_set_level(mcts, NIM_MCTS_HARD);
+	return (0);
+}
+
+/**
+ * Release the resources of @p mcts.
+ */
+void nim_mcts_free(struct nim_mcts *mcts)
+{
+	free(mcts->nodes);
+	free(mcts->table);
+	free(mcts->heaps);
+	free(mcts->nonempty);
+	memset(mcts, 0, sizeof(*mcts));
+}
+
+/**
+ * Returns the memory, in bytes, allocated by @p mcts: arena, table
+ * and scratch.
+ */
+size_t nim_mcts_memory(const struct nim_mcts *mcts)
+{
+	size_t size = 0;
+
+	if (mcts->nodes)
+		size += mcts->max_nodes * sizeof(*mcts->nodes);
+	if (mcts->table)
+		size += (mcts->table_mask + 1) * sizeof(*mcts->table);
+	return (size + mcts->cap * (sizeof(*mcts->heaps) +
+		sizeof(*mcts->nonempty)));
+}
+
+/**
+ * Set the search budget of @p mcts accordingly with the difficulty
+ * level @p level (NIM_MCTS_EASY, ...).
+ */
+void nim_mcts_set_level(struct nim_mcts *mcts, int level)
+{
+	if (level < 0 || level >= NIM_MCTS_LEVELS)
+		level = NIM_MCTS_HARD;
+	mcts->budget = levels[level];
+}
+
+/**
+ * Search the best move for @p pos within the current budget.
+ *
+ * Returns 0 if success, -1 if there is no move left, the search
+ * was stopped, or on allocation failure.
+ */
+int nim_mcts_best_move(struct nim_mcts *mcts, const struct nim_position *pos,
+	struct nim_move *move)
+{
+	struct mcts_node *c;
+	uint64_t *heaps;
+	size_t *nonempty;
+	double deadline;
+	uint32_t best;
+	size_t i;
+
+	if (nim_is_over(pos))
+		return (-1);
+
+	/* Scratch. */
+	if (pos->nheaps > mcts->cap)
+	{
+		heaps    = realloc(mcts->heaps, pos->nheaps * sizeof(*heaps));
+		nonempty = realloc(mcts->nonempty, pos->nheaps * sizeof(*nonempty));
+		if (heaps)
+			mcts->heaps = heaps;
+		if (nonempty)
+			mcts->nonempty = nonempty;
+		if (!heaps || !nonempty)
+			return (-1);
+		mcts->cap = pos->nheaps;
+	}
+
+	/* Reuse the arena and table: new generation, 0 is never used. */
+	mcts->count = 0;
+	if (!++mcts->generation)
+	{
+		memset(mcts->table, 0, (mcts->table_mask + 1) * sizeof(*mcts->table));
+		mcts->generation = 1;
+	}
+	new_node(mcts, NIL, NULL);
+	for (i = 0; i < pos->nheaps; i++)
+		mcts->nodes[0].key += heap_hash(pos->heaps[i]);
+
+	deadline = mcts->budget.seconds > 0.0 ? now() + mcts->budget.seconds : 0.0;
+
+	for (mcts->iterations = 0; !mcts->nodes[0].proven; mcts->iterations++)
+	{
+		if (mcts->budget.iterations &&
+			mcts->iterations >= mcts->budget.iterations)
+		{
+			break;
+		}
+
+		if (!(mcts->iterations % CHECK_INTERVAL))
+		{
+			if (deadline > 0.0 && mcts->iterations && now() >= deadline)
+				break;
+			if (mcts->stop && mcts->stop(mcts->stop_arg))
+				return (-1);
+		}
+
+		iterate(mcts, pos);
+	}
+
+	/* Proven win first, then the most visited move not proven lost. */
+	best = NIL;
+	for (i = mcts->nodes[0].child; i != NIL; i = c->sibling)
+	{
+		c = &mcts->nodes[i];
+		if (c->proven == PROVEN_WIN)
+		{
+			best = (uint32_t)i;
+			break;
+		}
+		if (best == NIL ||
+			(c->proven != PROVEN_LOSS &&
+				(mcts->nodes[best].proven == PROVEN_LOSS ||
+				c->visits > mcts->nodes[best].visits)))
+		{
+			best = (uint32_t)i;
+		}
+	}
+
+	/* Not even one iteration, any move. */
+	if (best == NIL)
+		return (nim_first_move(pos, move));
+
+	*move = mcts->nodes[best].move;
+	return (0);
+}
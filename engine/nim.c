@@ -0,0 +1,293 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "nim.h"
+#include "kernels.h"
+
+/*
+ * Rules:
+ * This is the 'misère' variant of Nim: the player who removes the
+ * last element, _loses_.
+ *
+ * All the routines below are linear in the amount of heaps and do
+ * not allocate memory. The passes over all the heaps done by the
+ * solver are vectorized when possible, see simd.c.
+ */
+
+/* ---------------------------------------------------------------------- */
+/* Position queries.                                                      */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Returns the nim-sum (xor of all heaps) of a given position.
+ */
+uint64_t nim_sum(const struct nim_position *pos)
+{
+	return (nim_kernels.xor_reduce(pos->heaps, pos->nheaps));
+}
+
+/**
+ * Returns the amount of elements remaining in all the heaps
+ * (modulo 2^64).
+ */
+uint64_t nim_remaining(const struct nim_position *pos)
+{
+	uint64_t count;
+	size_t i;
+
+	count = 0;
+	for (i = 0; i < pos->nheaps; i++)
+		count += pos->heaps[i];
+
+	return (count);
+}
+
+/**
+ * Returns 1 if there is no element left, 0 otherwise.
+ */
+int nim_is_over(const struct nim_position *pos)
+{
+	size_t i;
+
+	for (i = 0; i < pos->nheaps; i++)
+		if (pos->heaps[i] > 0)
+			return (0);
+
+	return (1);
+}
+
+/**
+ * Returns 1 if the move @p move is legal for the position @p pos,
+ * 0 otherwise.
+ */
+int nim_is_legal(const struct nim_position *pos,
+	const struct nim_move *move)
+{
+	if (move->heap >= pos->nheaps)
+		return (0);
+	if (move->amount < 1 || move->amount > pos->heaps[move->heap])
+		return (0);
+	return (1);
+}
+
+/* ---------------------------------------------------------------------- */
+/* Move generation.                                                       */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Seek the first non-empty heap starting at @p heap.
+ *
+ * Returns the heap index, or pos->nheaps if there is none.
+ */
+static size_t next_heap(const struct nim_position *pos, size_t heap)
+{
+	for (; heap < pos->nheaps; heap++)
+		if (pos->heaps[heap] > 0)
+			break;
+	return (heap);
+}
+
+/**
+ * Initializes @p move with the first legal move for the position
+ * @p pos.
+ *
+ * Returns 0 if there is a legal move, -1 otherwise (game over).
+ */
+int nim_first_move(const struct nim_position *pos,
+	struct nim_move *move)
+{
+	size_t heap;
+
+	if ((heap = next_heap(pos, 0)) == pos->nheaps)
+		return (-1);
+
+	move->heap   = heap;
+	move->amount = 1;
+	return (0);
+}
+
+/**
+ * Advances @p move (previously initialized by nim_first_move())
+ * to the next legal move, in (heap, amount) order.
+ *
+ * Returns 0 if there is a next move, -1 otherwise.
+ */
+int nim_next_move(const struct nim_position *pos,
+	struct nim_move *move)
+{
+	size_t heap;
+
+	if (move->amount < pos->heaps[move->heap])
+	{
+		move->amount++;
+		return (0);
+	}
+
+	if ((heap = next_heap(pos, move->heap + 1)) == pos->nheaps)
+		return (-1);
+
+	move->heap   = heap;
+	move->amount = 1;
+	return (0);
+}
+
+/**
+ * Apply the move @p move into the position @p pos.
+ *
+ * Returns 0 if success, -1 if the move is illegal.
+ */
+int nim_apply_move(struct nim_position *pos,
+	const struct nim_move *move)
+{
+	if (!nim_is_legal(pos, move))
+		return (-1);
+
+	pos->heaps[move->heap] -= move->amount;
+	return (0);
+}
+
+/* ---------------------------------------------------------------------- */
+/* Solver.                                                                */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Count the amount of heaps with more than one element.
+ */
+static size_t count_greater_than_one(const struct nim_position *pos)
+{
+	return (nim_kernels.count_gt_one(pos->heaps, pos->nheaps));
+}
+
+/**
+ * Find the first heap that can be reduced in order to make the
+ * nim-sum zero, i.e: heap ^ nim < heap.
+ *
+ * Returns the heap index, or pos->nheaps if there is none.
+ */
+static size_t find_winning_heap(const struct nim_position *pos,
+	uint64_t nim)
+{
+	return (nim_kernels.find_winning(pos->heaps, pos->nheaps, nim));
+}
+
+/**
+ * Returns 1 if the player to move at @p pos wins with perfect
+ * play, 0 otherwise.
+ */
+int nim_is_winning(const struct nim_position *pos)
+{
+	uint64_t nim;
+
+	nim = nim_sum(pos);
+
+	/*
+	 * Only heaps of one element: the nim-sum is the parity of
+	 * the amount of heaps, and the player to move wins if that
+	 * amount is even.
+	 */
+	if (!count_greater_than_one(pos))
+		return (nim == 0);
+
+	return (nim != 0);
+}
+
+/**
+ * Computer "AI", i.e: algorithm that chooses the best heap and
+ * amount to remove.
+ *
+ * Returns 0 if success, -1 if there is no move left.
+ */
+int nim_best_move(const struct nim_position *pos, struct nim_move *move)
+{
+	size_t greater_than_one;
+	uint64_t nim;
+	uint64_t amnt;
+	size_t i;
+
+	/* Count amount of heaps with more than one crystal. */
+	greater_than_one = count_greater_than_one(pos);
+
+	/* Nim sum. */
+	nim = nim_sum(pos);
+
+	/*
+	 * Two options here:
+	 *
+	 * a) If nim_sum != 0, the computer _will_ win =).
+	 *
+	 * b) If nim_sum is 0, the computer have no way to create another
+	 *    sequence that has 0 as the nim_sum value, in other words:
+	 *    computer will lose if the player keeps playing like this =).
+	 */
+	if (nim)
+	{
+		/* Recalculate nim-sum. */
+		i    = find_winning_heap(pos, nim);
+		amnt = pos->heaps[i] ^ nim;
+
+		move->heap = i;
+
+		/*
+		 * We have 2 options here: (again)
+		 * a) More than one heap with more than one stick
+		 * b) Exactly one heap with more than one stick
+		 *
+		 * The option b) do not conforms with the maths as
+		 * expected and we fall in a case were we remove
+		 * n or n-1 sticks from that column. So is necessary
+		 * to bifurcate these two scenarios here.
+		 */
+
+		/* Scenario a). */
+		if (greater_than_one != 1)
+			move->amount = pos->heaps[i] - amnt;
+
+		/*
+		 * Scenario b).
+		 *
+		 * All the other heaps have 0 or 1 crystals, so the
+		 * lowest bit of 'amnt' (the xor of all the other
+		 * heaps) is the parity of the remaining crystals.
+		 */
+		else
+		{
+			/* Odd number of crystals, remove all row. */
+			if (amnt & 1)
+				move->amount = pos->heaps[i];
+
+			/* Even number, remove n-1 crystals. */
+			else
+				move->amount = pos->heaps[i] - 1;
+		}
+	}
+
+	/*
+	 * There is no way to get nin_sum == 0 here, so let us remove
+	 * a single piece and hope the player makes a wrong move.
+	 */
+	else
+		return (nim_first_move(pos, move));
+
+	return (0);
+}
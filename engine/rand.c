@@ -0,0 +1,145 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "nim_rand.h"
+
+/*
+ * xoshiro256** by David Blackman and Sebastiano Vigna, seeded
+ * with splitmix64, as recommended by the authors.
+ */
+
+/**
+ * splitmix64 step, for the seeding.
+ */
+static uint64_t splitmix64(uint64_t *x)
+{
+	uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return (z ^ (z >> 31));
+}
+
+/**
+ * Initialize @p r from the seed @p seed; any seed (0 included)
+ * is valid, and the same seed always gives the same sequence.
+ */
+void nim_rand_seed(struct nim_rand *r, uint64_t seed)
+{
+	int i;
+	for (i = 0; i < 4; i++)
+		r->s[i] = splitmix64(&seed);
+}
+
+/**
+ * Map the 32-bit value @p x into [0, @p range) (0 < range <= 2^32),
+ * Lemire's multiply-and-reject: no bias and, almost always, no
+ * division. @p threshold is (2^32 - range) % range.
+ *
+ * Returns the value, or -1 if @p x must be rejected.
+ */
+static inline int64_t map32(uint32_t x, uint64_t range, uint32_t threshold)
+{
+	uint64_t m = (uint64_t)x * range;
+	if ((uint32_t)m < threshold)
+		return (-1);
+	return ((int64_t)(m >> 32));
+}
+
+/**
+ * Returns an uniformly distributed value within [@p lo, @p hi].
+ */
+uint64_t nim_rand_range(struct nim_rand *r, uint64_t lo, uint64_t hi)
+{
+	uint32_t threshold;
+	uint64_t range;
+	uint64_t mask;
+	uint64_t v;
+	int64_t x;
+
+	range = hi - lo + 1;
+	if (!range)
+		return (nim_rand_next(r));
+
+	/* Small ranges: 32-bit multiply. */
+	if (range <= (1ULL << 32))
+	{
+		threshold = (uint32_t)((1ULL << 32) % range);
+		while ((x = map32((uint32_t)(nim_rand_next(r) >> 32), range,
+			threshold)) < 0);
+		return (lo + (uint64_t)x);
+	}
+
+	/* Large ranges: bitmask and reject. */
+	mask = range - 1;
+	mask |= mask >> 1;
+	mask |= mask >> 2;
+	mask |= mask >> 4;
+	mask |= mask >> 8;
+	mask |= mask >> 16;
+	mask |= mask >> 32;
+	while ((v = nim_rand_next(r) & mask) >= range);
+	return (lo + v);
+}
+
+/**
+ * Fill @p nboards boards of @p nheaps heaps each, stored
+ * contiguously in @p heaps, with heap sizes uniformly distributed
+ * within [@p lo, @p hi].
+ *
+ * For ranges up to 2^32 (all the real boards) each 64-bit output
+ * gives two heaps.
+ */
+void nim_rand_boards(struct nim_rand *r, uint64_t *heaps, size_t nboards,
+	size_t nheaps, uint64_t lo, uint64_t hi)
+{
+	uint32_t threshold;
+	uint64_t range;
+	uint64_t v;
+	int64_t x;
+	size_t count;
+	size_t i;
+
+	count = nboards * nheaps;
+	range = hi - lo + 1;
+
+	if (!range || range > (1ULL << 32))
+	{
+		for (i = 0; i < count; i++)
+			heaps[i] = nim_rand_range(r, lo, hi);
+		return;
+	}
+
+	threshold = (uint32_t)((1ULL << 32) % range);
+	for (i = 0; i < count; )
+	{
+		v = nim_rand_next(r);
+		if ((x = map32((uint32_t)(v >> 32), range, threshold)) >= 0)
+			heaps[i++] = lo + (uint64_t)x;
+		if (i < count &&
+			(x = map32((uint32_t)v, range, threshold)) >= 0)
+		{
+			heaps[i++] = lo + (uint64_t)x;
+		}
+	}
+}
@@ -0,0 +1,486 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "nim.h"
+#include "kernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#define HAVE_X86_SIMD
+	#include <immintrin.h>
+#endif
+
+#if defined(__wasm_simd128__)
+	#define HAVE_WASM_SIMD
+	#include <wasm_simd128.h>
+#endif
+
+/*
+ * Note on the winning heap search:
+ * heap ^ nim < heap holds if and only if heap has the most
+ * significant bit of nim set, so the vectorized versions
+ * below only need a single 'and' per heap.
+ */
+
+/* ---------------------------------------------------------------------- */
+/* Scalar kernels.                                                        */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Scalar xor reduction.
+ */
+static uint64_t xor_reduce_scalar(const uint64_t *heaps, size_t n)
+{
+	uint64_t sum;
+	size_t i;
+
+	sum = 0;
+	for (i = 0; i < n; i++)
+		sum ^= heaps[i];
+
+	return (sum);
+}
+
+/**
+ * Scalar count of heaps greater than one.
+ */
+static size_t count_gt_one_scalar(const uint64_t *heaps, size_t n)
+{
+	size_t count;
+	size_t i;
+
+	count = 0;
+	for (i = 0; i < n; i++)
+		count += (heaps[i] > 1);
+
+	return (count);
+}
+
+/**
+ * Scalar winning heap search.
+ */
+static size_t find_winning_scalar(const uint64_t *heaps, size_t n,
+	uint64_t nim)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++)
+		if ((heaps[i] ^ nim) < heaps[i])
+			break;
+
+	return (i);
+}
+
+/**
+ * Returns the most significant bit set of @p nim (that
+ * should be != 0).
+ */
+static inline uint64_t top_bit(uint64_t nim)
+{
+	while (nim & (nim - 1))
+		nim &= nim - 1;
+	return (nim);
+}
+
+/* ---------------------------------------------------------------------- */
+/* SSE2 kernels.                                                          */
+/* ---------------------------------------------------------------------- */
+#if defined(HAVE_X86_SIMD)
+
+/**
+ * SSE2 xor reduction, 4 heaps per iteration.
+ */
+__attribute__((target("sse2")))
+static uint64_t xor_reduce_sse2(const uint64_t *heaps, size_t n)
+{
+	__m128i acc0;
+	__m128i acc1;
+	uint64_t lanes[2];
+	size_t i;
+
+	acc0 = _mm_setzero_si128();
+	acc1 = _mm_setzero_si128();
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		acc0 = _mm_xor_si128(acc0,
+			_mm_loadu_si128((const __m128i *)(heaps + i)));
+		acc1 = _mm_xor_si128(acc1,
+			_mm_loadu_si128((const __m128i *)(heaps + i + 2)));
+	}
+
+	_mm_storeu_si128((__m128i *)lanes, _mm_xor_si128(acc0, acc1));
+	return (lanes[0] ^ lanes[1] ^ xor_reduce_scalar(heaps + i, n - i));
+}
+
+/**
+ * SSE2 count of heaps greater than one.
+ *
+ * SSE2 has no 64-bit compare, so a 64-bit lane is tested
+ * against zero by combining both of its 32-bit halves.
+ */
+__attribute__((target("sse2")))
+static size_t count_gt_one_sse2(const uint64_t *heaps, size_t n)
+{
+	__m128i not_one;
+	__m128i zeros;
+	__m128i acc;
+	__m128i eq;
+	uint64_t lanes[2];
+	size_t i;
+
+	not_one = _mm_set1_epi64x(~(int64_t)1);
+	zeros   = _mm_setzero_si128();
+	acc     = _mm_setzero_si128();
+
+	for (i = 0; i + 2 <= n; i += 2)
+	{
+		eq = _mm_cmpeq_epi32(_mm_and_si128(not_one,
+			_mm_loadu_si128((const __m128i *)(heaps + i))), zeros);
+		eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, 0xB1));
+
+		/* Lanes <= 1 are all-ones, i.e: -1. */
+		acc = _mm_sub_epi64(acc, eq);
+	}
+
+	_mm_storeu_si128((__m128i *)lanes, acc);
+	return ((i - (size_t)(lanes[0] + lanes[1])) +
+		count_gt_one_scalar(heaps + i, n - i));
+}
+
+/**
+ * SSE2 winning heap search.
+ */
+__attribute__((target("sse2")))
+static size_t find_winning_sse2(const uint64_t *heaps, size_t n,
+	uint64_t nim)
+{
+	__m128i zeros;
+	__m128i top;
+	__m128i eq;
+	int mask;
+	size_t i;
+
+	top   = _mm_set1_epi64x((int64_t)top_bit(nim));
+	zeros = _mm_setzero_si128();
+
+	for (i = 0; i + 2 <= n; i += 2)
+	{
+		/* Only one bit is tested, so 32-bit compares suffice. */
+		eq = _mm_cmpeq_epi32(_mm_and_si128(top,
+			_mm_loadu_si128((const __m128i *)(heaps + i))), zeros);
+
+		mask = _mm_movemask_epi8(eq) ^ 0xFFFF;
+		if (mask)
+			return (i + (size_t)(__builtin_ctz(mask) >> 3));
+	}
+
+	return (i + find_winning_scalar(heaps + i, n - i, nim));
+}
+
+/* ---------------------------------------------------------------------- */
+/* AVX2 kernels.                                                          */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * AVX2 xor reduction, 8 heaps per iteration.
+ */
+__attribute__((target("avx2")))
+static uint64_t xor_reduce_avx2(const uint64_t *heaps, size_t n)
+{
+	__m256i acc0;
+	__m256i acc1;
+	uint64_t lanes[4];
+	size_t i;
+
+	acc0 = _mm256_setzero_si256();
+	acc1 = _mm256_setzero_si256();
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		acc0 = _mm256_xor_si256(acc0,
+			_mm256_loadu_si256((const __m256i *)(heaps + i)));
+		acc1 = _mm256_xor_si256(acc1,
+			_mm256_loadu_si256((const __m256i *)(heaps + i + 4)));
+	}
+
+	_mm256_storeu_si256((__m256i *)lanes, _mm256_xor_si256(acc0, acc1));
+	return (lanes[0] ^ lanes[1] ^ lanes[2] ^ lanes[3] ^
+		xor_reduce_scalar(heaps + i, n - i));
+}
+
+/**
+ * AVX2 count of heaps greater than one.
+ */
+__attribute__((target("avx2")))
+static size_t count_gt_one_avx2(const uint64_t *heaps, size_t n)
+{
+	__m256i not_one;
+	__m256i zeros;
+	__m256i acc;
+	uint64_t lanes[4];
+	size_t i;
+
+	not_one = _mm256_set1_epi64x(~(int64_t)1);
+	zeros   = _mm256_setzero_si256();
+	acc     = _mm256_setzero_si256();
+
+	/* Lanes <= 1 are all-ones, i.e: -1. */
+	for (i = 0; i + 4 <= n; i += 4)
+		acc = _mm256_sub_epi64(acc, _mm256_cmpeq_epi64(
+			_mm256_and_si256(not_one,
+			_mm256_loadu_si256((const __m256i *)(heaps + i))), zeros));
+
+	_mm256_storeu_si256((__m256i *)lanes, acc);
+	return ((i - (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3])) +
+		count_gt_one_scalar(heaps + i, n - i));
+}
+
+/**
+ * AVX2 winning heap search.
+ */
+__attribute__((target("avx2")))
+static size_t find_winning_avx2(const uint64_t *heaps, size_t n,
+	uint64_t nim)
+{
+	__m256i zeros;
+	__m256i top;
+	__m256i eq;
+	int mask;
+	size_t i;
+
+	top   = _mm256_set1_epi64x((int64_t)top_bit(nim));
+	zeros = _mm256_setzero_si256();
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		eq = _mm256_cmpeq_epi64(_mm256_and_si256(top,
+			_mm256_loadu_si256((const __m256i *)(heaps + i))), zeros);
+
+		mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq)) ^ 0xF;
+		if (mask)
+			return (i + (size_t)__builtin_ctz(mask));
+	}
+
+	return (i + find_winning_scalar(heaps + i, n - i, nim));
+}
+#endif /* HAVE_X86_SIMD. */
+
+/* ---------------------------------------------------------------------- */
+/* WebAssembly SIMD kernels.                                              */
+/* ---------------------------------------------------------------------- */
+#if defined(HAVE_WASM_SIMD)
+
+/**
+ * WASM SIMD xor reduction, 4 heaps per iteration.
+ */
+static uint64_t xor_reduce_wasm(const uint64_t *heaps, size_t n)
+{
+	v128_t acc0;
+	v128_t acc1;
+	size_t i;
+
+	acc0 = wasm_i64x2_splat(0);
+	acc1 = wasm_i64x2_splat(0);
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		acc0 = wasm_v128_xor(acc0, wasm_v128_load(heaps + i));
+		acc1 = wasm_v128_xor(acc1, wasm_v128_load(heaps + i + 2));
+	}
+
+	acc0 = wasm_v128_xor(acc0, acc1);
+	return ((uint64_t)wasm_i64x2_extract_lane(acc0, 0) ^
+		(uint64_t)wasm_i64x2_extract_lane(acc0, 1) ^
+		xor_reduce_scalar(heaps + i, n - i));
+}
+
+/**
+ * WASM SIMD count of heaps greater than one.
+ */
+static size_t count_gt_one_wasm(const uint64_t *heaps, size_t n)
+{
+	v128_t not_one;
+	v128_t zeros;
+	v128_t acc;
+	size_t i;
+
+	not_one = wasm_i64x2_splat(~(int64_t)1);
+	zeros   = wasm_i64x2_splat(0);
+	acc     = wasm_i64x2_splat(0);
+
+	/* Lanes <= 1 are all-ones, i.e: -1. */
+	for (i = 0; i + 2 <= n; i += 2)
+		acc = wasm_i64x2_sub(acc, wasm_i64x2_eq(
+			wasm_v128_and(not_one, wasm_v128_load(heaps + i)), zeros));
+
+	return ((i - (size_t)(wasm_i64x2_extract_lane(acc, 0) +
+		wasm_i64x2_extract_lane(acc, 1))) +
+		count_gt_one_scalar(heaps + i, n - i));
+}
+
+/**
+ * WASM SIMD winning heap search.
+ */
+static size_t find_winning_wasm(const uint64_t *heaps, size_t n,
+	uint64_t nim)
+{
+	v128_t zeros;
+	v128_t top;
+	uint32_t mask;
+	size_t i;
+
+	top   = wasm_i64x2_splat((int64_t)top_bit(nim));
+	zeros = wasm_i64x2_splat(0);
+
+	for (i = 0; i + 2 <= n; i += 2)
+	{
+		mask = wasm_i64x2_bitmask(wasm_i64x2_ne(
+			wasm_v128_and(top, wasm_v128_load(heaps + i)), zeros));
+
+		if (mask)
+			return (i + (mask & 1 ? 0 : 1));
+	}
+
+	return (i + find_winning_scalar(heaps + i, n - i, nim));
+}
+#endif /* HAVE_WASM_SIMD. */
+
+/* ---------------------------------------------------------------------- */
+/* Dispatch.                                                              */
+/* ---------------------------------------------------------------------- */
+
+/* Current kernels, scalar until nim_simd_select() is invoked. */
+struct nim_kernels nim_kernels = {
+	xor_reduce_scalar,
+	count_gt_one_scalar,
+	find_winning_scalar
+};
+
+/* Current SIMD level. */
+static int simd_level = NIM_SIMD_SCALAR;
+
+/**
+ * Returns 1 if the running CPU supports the SIMD level @p level,
+ * 0 otherwise.
+ */
+static int simd_supported(int level)
+{
+#if defined(HAVE_X86_SIMD)
+	__builtin_cpu_init();
+#endif
+
+	switch (level)
+	{
+		case NIM_SIMD_SCALAR:
+			return (1);
+#if defined(HAVE_X86_SIMD)
+		case NIM_SIMD_SSE2:
+			return (__builtin_cpu_supports("sse2"));
+		case NIM_SIMD_AVX2:
+			return (__builtin_cpu_supports("avx2"));
+#endif
+#if defined(HAVE_WASM_SIMD)
+		case NIM_SIMD_WASM:
+			return (1);
+#endif
+		default:
+			return (0);
+	}
+}
+
+/**
+ * Select the kernels used by the solver.
+ *
+ * @p level is one of the NIM_SIMD_* values; NIM_SIMD_AUTO picks
+ * the best supported one. If the requested level is not supported,
+ * falls back to the scalar kernels.
+ *
+ * This is not thread-safe: call it before sharing the engine
+ * between threads.
+ *
+ * Returns the level actually selected.
+ */
+int nim_simd_select(int level)
+{
+	if (level == NIM_SIMD_AUTO)
+	{
+		for (level = NIM_SIMD_WASM; level > NIM_SIMD_SCALAR; level--)
+			if (simd_supported(level))
+				break;
+	}
+	else if (!simd_supported(level))
+		level = NIM_SIMD_SCALAR;
+
+	switch (level)
+	{
+#if defined(HAVE_X86_SIMD)
+		case NIM_SIMD_SSE2:
+			nim_kernels.xor_reduce   = xor_reduce_sse2;
+			nim_kernels.count_gt_one = count_gt_one_sse2;
+			nim_kernels.find_winning = find_winning_sse2;
+			break;
+		case NIM_SIMD_AVX2:
+			nim_kernels.xor_reduce   = xor_reduce_avx2;
+			nim_kernels.count_gt_one = count_gt_one_avx2;
+			nim_kernels.find_winning = find_winning_avx2;
+			break;
+#endif
+#if defined(HAVE_WASM_SIMD)
+		case NIM_SIMD_WASM:
+			nim_kernels.xor_reduce   = xor_reduce_wasm;
+			nim_kernels.count_gt_one = count_gt_one_wasm;
+			nim_kernels.find_winning = find_winning_wasm;
+			break;
+#endif
+		default:
+			nim_kernels.xor_reduce   = xor_reduce_scalar;
+			nim_kernels.count_gt_one = count_gt_one_scalar;
+			nim_kernels.find_winning = find_winning_scalar;
+			break;
+	}
+
+	simd_level = level;
+	return (level);
+}
+
+/**
+ * Returns a printable name for the current SIMD level.
+ */
+const char *nim_simd_name(void)
+{
+	static const char *const names[] = {"scalar", "sse2", "avx2", "wasm"};
+	return (names[simd_level]);
+}
+
+#if defined(__GNUC__)
+/**
+ * Pick the best kernels before main(), so that the engine
+ * is never racing against itself when used by threads.
+ */
+__attribute__((constructor))
+static void simd_init(void)
+{
+	nim_simd_select(NIM_SIMD_AUTO);
+}
+#endif
@@ -0,0 +1,542 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "nim_tb.h"
+
+/*
+ * Indexing:
+ * A canonical position is a non-decreasing sequence of exactly
+ * 'max_heaps' (K) heaps h[0] <= ... <= h[K-1] <= max_size (M),
+ * padded with empty heaps at the beginning. Such a sequence maps
+ * to the K-combination c[p] = h[p] + p of {0, ..., M+K-1}, and
+ * its index is the combinatorial number system (colex) rank:
+ *
+ *   index = sum_{p=0}^{K-1} C(h[p] + p, p + 1)
+ *
+ * which is a bijection over [0, C(M+K, K)).
+ *
+ * Since removing elements from a heap gives a sequence that is
+ * pointwise smaller than (or equal to) the original one, every
+ * successor of a position has a smaller index, and the whole
+ * table can be solved by a single sweep in increasing index
+ * order, starting from the terminal position (index 0).
+ */
+
+/*
+ * On-disk header, NIM_TB_HEADER_SIZE bytes long, followed by
+ * the win/loss bits, in native byte order.
+ */
+struct tb_header
+{
+	char magic[8];
+	uint32_t max_heaps;
+	uint32_t misere;
+	uint64_t max_size;
+	uint64_t take_mask;
+	uint64_t positions;
+	uint8_t reserved[24];
+};
+
+/* ---------------------------------------------------------------------- */
+/* Helpers.                                                               */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Returns 1 if removing @p amount elements from a heap is
+ * allowed by the variant @p variant, 0 otherwise.
+ */
+int nim_variant_allows(const struct nim_variant *variant, uint64_t amount)
+{
+	if (!amount)
+		return (0);
+	if (!variant->take_mask)
+		return (1);
+	return (amount <= 64 && ((variant->take_mask >> (amount - 1)) & 1));
+}
+
+/**
+ * Returns the maximum amount that can be removed from a heap
+ * of @p heap elements.
+ */
+static uint64_t max_amount(const struct nim_variant *variant, uint64_t heap)
+{
+	if (variant->take_mask && heap > 64)
+		return (64);
+	return (heap);
+}
+
+/**
+ * Build the binomial table used to index @p tb, i.e: C(n, k) for
+ * 0 <= k <= max_heaps and 0 <= n <= max_size + max_heaps.
+ *
+ * Returns 0 if success, -1 otherwise (including if the amount of
+ * positions is too big).
+ */
+static int build_binom(struct nim_tb *tb)
+{
+	uint64_t *b;
+	size_t rows;
+	size_t n;
+	size_t k;
+
+	if (!tb->max_heaps || tb->max_heaps > NIM_TB_MAX_HEAPS ||
+		tb->max_size > NIM_TB_MAX_SIZE)
+	{
+		return (-1);
+	}
+
+	rows = (size_t)tb->max_size + tb->max_heaps + 1;
+	b = calloc(rows * (tb->max_heaps + 1), sizeof(*b));
+	if (!b)
+		return (-1);
+
+	/* C(n, k) = C(n-1, k-1) + C(n-1, k), saturated. */
+	for (k = 0; k <= tb->max_heaps; k++)
+	{
+		for (n = 0; n < rows; n++)
+		{
+			if (!k || n == k)
+				b[k * rows + n] = 1;
+			else if (n < k)
+				b[k * rows + n] = 0;
+			else
+			{
+				b[k * rows + n] = b[(k - 1) * rows + n - 1] +
+					b[k * rows + n - 1];
+				if (b[k * rows + n] < b[k * rows + n - 1])
+					b[k * rows + n] = UINT64_MAX;
+			}
+		}
+	}
+
+	tb->binom = b;
+	tb->positions = b[tb->max_heaps * rows + rows - 1];
+	if (tb->positions > NIM_TB_MAX_POSITIONS)
+	{
+		free(b);
+		tb->binom = NULL;
+		return (-1);
+	}
+	return (0);
+}
+
+/**
+ * Returns the rank term of the heap @p h at the sorted
+ * position @p p.
+ */
+static inline uint64_t term(const struct nim_tb *tb, size_t p, uint64_t h)
+{
+	size_t rows = (size_t)tb->max_size + tb->max_heaps + 1;
+	return (tb->binom[(p + 1) * rows + (size_t)h + p]);
+}
+
+/**
+ * Returns the bit @p idx of @p bits.
+ */
+static inline int get_bit(const uint8_t *bits, uint64_t idx)
+{
+	return ((bits[idx >> 3] >> (idx & 7)) & 1);
+}
+
+/**
+ * Sort the non-empty heaps of @p pos into @p sorted (padded with
+ * empty heaps at the beginning, as the canonical form), keeping
+ * their original indexes at @p orig (if not NULL).
+ *
+ * Returns 0 if success, -1 if the position does not fit in the
+ * tablebase limits.
+ */
+static int canonical(const struct nim_tb *tb, const struct nim_position *pos,
+	uint64_t *sorted, size_t *orig)
+{
+	size_t count;
+	size_t i;
+	size_t j;
+	size_t k;
+
+	count = 0;
+	k = tb->max_heaps;
+
+	for (i = 0; i < pos->nheaps; i++)
+	{
+		if (!pos->heaps[i])
+			continue;
+		if (count == k || pos->heaps[i] > tb->max_size)
+			return (-1);
+
+		/* Insertion sort, into the last 'count' slots. */
+		for (j = k - count - 1; j < k - 1 && sorted[j + 1] < pos->heaps[i];
+			j++)
+		{
+			sorted[j] = sorted[j + 1];
+			if (orig)
+				orig[j] = orig[j + 1];
+		}
+		sorted[j] = pos->heaps[i];
+		if (orig)
+			orig[j] = i;
+		count++;
+	}
+
+	for (i = 0; i < k - count; i++)
+	{
+		sorted[i] = 0;
+		if (orig)
+			orig[i] = pos->nheaps;
+	}
+	return (0);
+}
+
+/**
+ * Returns the index of the canonical position @p sorted.
+ */
+static uint64_t rank(const struct nim_tb *tb, const uint64_t *sorted)
+{
+	uint64_t idx;
+	size_t p;
+
+	idx = 0;
+	for (p = 0; p < tb->max_heaps; p++)
+		idx += term(tb, p, sorted[p]);
+	return (idx);
+}
+
+/* ---------------------------------------------------------------------- */
+/* Generation.                                                            */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Solve the canonical position @p h (of index @p idx), given that
+ * all the positions with smaller indexes are already solved.
+ *
+ * Returns 1 if the player to move wins, 0 otherwise.
+ */
+static int solve(const struct nim_tb *tb, const uint64_t *h,
+	uint64_t *prefix, uint64_t *shifted, uint64_t *suffix)
+{
+	uint64_t amount;
+	uint64_t idx;
+	uint64_t v;
+	size_t k;
+	size_t i;
+	size_t j;
+	int moved;
+
+	k = tb->max_heaps;
+
+	/*
+	 * Replacing h[i] by v < h[i] moves v to the first slot j
+	 * with h[j] > v, shifting h[j..i-1] one slot to the right,
+	 * so the successor index is:
+	 *
+	 *   prefix[j] + term(j, v) + (shifted[i] - shifted[j]) + suffix[i]
+	 *
+	 * prefix[p]  = sum_{q < p} term(q, h[q])
+	 * shifted[p] = sum_{1 <= q <= p} term(q, h[q-1])
+	 * suffix[p]  = sum_{q > p} term(q, h[q])
+	 */
+	prefix[0]  = 0;
+	shifted[0] = 0;
+	for (i = 1; i <= k; i++)
+	{
+		prefix[i] = prefix[i - 1] + term(tb, i - 1, h[i - 1]);
+		if (i < k)
+			shifted[i] = shifted[i - 1] + term(tb, i, h[i - 1]);
+	}
+	for (i = 0; i < k; i++)
+		suffix[i] = prefix[k] - prefix[i + 1];
+
+	moved = 0;
+	for (i = 0; i < k; i++)
+	{
+		/* Equal heaps lead to the same successors. */
+		if (!h[i] || (i + 1 < k && h[i] == h[i + 1]))
+			continue;
+
+		j = i;
+		for (amount = 1; amount <= max_amount(&tb->variant, h[i]); amount++)
+		{
+			if (!nim_variant_allows(&tb->variant, amount))
+				continue;
+
+			v = h[i] - amount;
+			while (j > 0 && h[j - 1] > v)
+				j--;
+
+			idx = prefix[j] + term(tb, j, v) + (shifted[i] - shifted[j]) +
+				suffix[i];
+
+			moved = 1;
+			if (!get_bit(tb->bits, idx))
+				return (1);
+		}
+	}
+
+	/* No moves left: the last player to move wins in misère. */
+	if (!moved)
+		return (tb->variant.misere);
+
+	return (0);
+}
+
+/**
+ * Exhaustively solve the variant @p variant for all positions with
+ * up to @p max_heaps non-empty heaps of up to @p max_size elements
+ * and save the resulting tablebase into @p path.
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+int nim_tb_generate(const char *path, const struct nim_variant *variant,
+	size_t max_heaps, uint64_t max_size)
+{
+	struct tb_header hdr;
+	struct nim_tb tb;
+	uint64_t *scratch;
+	uint8_t *bits;
+	uint64_t *h;
+	uint64_t idx;
+	size_t nbytes;
+	size_t i;
+	FILE *f;
+	int ret;
+
+	memset(&tb, 0, sizeof(tb));
+	tb.variant   = *variant;
+	tb.max_heaps = max_heaps;
+	tb.max_size  = max_size;
+
+	if (build_binom(&tb) < 0)
+		return (-1);
+
+	ret     = -1;
+	f       = NULL;
+	nbytes  = (size_t)((tb.positions + 7) >> 3);
+	bits    = calloc(nbytes, 1);
+	scratch = calloc(max_heaps * 4 + 1, sizeof(*scratch));
+	if (!bits || !scratch)
+		goto out;
+
+	tb.bits = bits;
+	h = scratch + 3 * max_heaps + 1;
+
+	/* Walk all the canonical positions, in index order. */
+	for (idx = 0; idx < tb.positions; idx++)
+	{
+		if (solve(&tb, h, scratch, scratch + max_heaps + 1,
+			scratch + 2 * max_heaps + 1))
+		{
+			bits[idx >> 3] |= (uint8_t)(1 << (idx & 7));
+		}
+
+		/* Next position: colex successor. */
+		for (i = 0; i < max_heaps - 1 && h[i] == h[i + 1]; i++);
+		h[i]++;
+		while (i > 0)
+			h[--i] = 0;
+	}
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, NIM_TB_MAGIC, sizeof(NIM_TB_MAGIC));
+	hdr.max_heaps = (uint32_t)max_heaps;
+	hdr.misere    = (uint32_t)variant->misere;
+	hdr.max_size  = max_size;
+	hdr.take_mask = variant->take_mask;
+	hdr.positions = tb.positions;
+
+	if (!(f = fopen(path, "wb")))
+		goto out;
+	if (fwrite(&hdr, sizeof(hdr), 1, f) != 1 ||
+		fwrite(bits, 1, nbytes, f) != nbytes)
+	{
+		goto out;
+	}
+
+	ret = 0;
+out:
+	if (f && fclose(f))
+		ret = -1;
+	free(scratch);
+	free(bits);
+	free(tb.binom);
+	return (ret);
+}
+
+/* ---------------------------------------------------------------------- */
+/* Lookup.                                                                */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Memory-map the tablebase file @p path into @p tb.
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+int nim_tb_open(struct nim_tb *tb, const char *path)
+{
+	struct tb_header hdr;
+	struct stat st;
+	void *map;
+	int fd;
+
+	memset(tb, 0, sizeof(*tb));
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		return (-1);
+
+	if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(hdr))
+	{
+		close(fd);
+		return (-1);
+	}
+
+	map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return (-1);
+
+	memcpy(&hdr, map, sizeof(hdr));
+	tb->map       = map;
+	tb->map_size  = (size_t)st.st_size;
+	tb->max_heaps = hdr.max_heaps;
+	tb->max_size  = hdr.max_size;
+	tb->variant.misere    = (int)hdr.misere;
+	tb->variant.take_mask = hdr.take_mask;
+	tb->bits = (const uint8_t *)map + NIM_TB_HEADER_SIZE;
+
+	if (memcmp(hdr.magic, NIM_TB_MAGIC, sizeof(NIM_TB_MAGIC)) ||
+		build_binom(tb) < 0 || tb->positions != hdr.positions ||
+		tb->map_size < NIM_TB_HEADER_SIZE + ((tb->positions + 7) >> 3))
+	{
+		nim_tb_close(tb);
+		return (-1);
+	}
+	return (0);
+}
+
+/**
+ * Unmap the tablebase @p tb.
+ */
+void nim_tb_close(struct nim_tb *tb)
+{
+	if (tb->map)
+		munmap(tb->map, tb->map_size);
+	free(tb->binom);
+	memset(tb, 0, sizeof(*tb));
+}
+
+/**
+ * Returns the heap memory, in bytes, used by @p tb, i.e: the
+ * binomial table; the mapping ('map_size') is not included.
+ */
+size_t nim_tb_memory(const struct nim_tb *tb)
+{
+	size_t size = 0;
+
+	if (tb->binom)
+		size += ((size_t)tb->max_size + tb->max_heaps + 1) *
+			(tb->max_heaps + 1) * sizeof(*tb->binom);
+	return (size);
+}
+
+/**
+ * Lookup the position @p pos in the tablebase @p tb.
+ *
+ * Returns 1 if the player to move wins, 0 if loses, and -1 if
+ * the position is not covered by the tablebase.
+ */
+int nim_tb_probe(const struct nim_tb *tb, const struct nim_position *pos)
+{
+	uint64_t sorted[NIM_TB_MAX_HEAPS];
+
+	if (!tb->bits || canonical(tb, pos, sorted, NULL) < 0)
+		return (-1);
+
+	return (get_bit(tb->bits, rank(tb, sorted)));
+}
+
+/**
+ * Choose the best move for @p pos using the tablebase @p tb: a
+ * move to a losing position if there is one, otherwise, remove
+ * the smallest amount possible and hope for a mistake.
+ *
+ * Returns 0 if success, -1 if there is no legal move or if the
+ * position is not covered by the tablebase.
+ */
+int nim_tb_best_move(const struct nim_tb *tb, const struct nim_position *pos,
+	struct nim_move *move)
+{
+	uint64_t sorted[NIM_TB_MAX_HEAPS];
+	uint64_t moved[NIM_TB_MAX_HEAPS];
+	size_t orig[NIM_TB_MAX_HEAPS];
+	struct nim_position succ;
+	uint64_t amount;
+	size_t i;
+	int found;
+
+	if (!tb->bits || canonical(tb, pos, sorted, orig) < 0)
+		return (-1);
+
+	succ.heaps  = moved;
+	succ.nheaps = tb->max_heaps;
+
+	found = 0;
+	for (i = 0; i < tb->max_heaps; i++)
+	{
+		if (!sorted[i])
+			continue;
+
+		for (amount = 1; amount <= max_amount(&tb->variant, sorted[i]);
+			amount++)
+		{
+			if (!nim_variant_allows(&tb->variant, amount))
+				continue;
+
+			/* Remember the first legal move. */
+			if (!found)
+			{
+				move->heap   = orig[i];
+				move->amount = amount;
+				found = 1;
+			}
+
+			memcpy(moved, sorted, tb->max_heaps * sizeof(*moved));
+			moved[i] -= amount;
+			if (!nim_tb_probe(tb, &succ))
+			{
+				move->heap   = orig[i];
+				move->amount = amount;
+				return (0);
+			}
+		}
+	}
+
+	return (found ? 0 : -1);
+}
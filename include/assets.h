@@ -0,0 +1,77 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef ASSETS_H
+#define ASSETS_H
+
+	#include <stdbool.h>
+	#include "raylib.h"
+
+	/*
+	 * Asset streaming.
+	 *
+	 * The assets are decoded (from the embedded resources, see
+	 * res.h) on a background thread started as soon as the process
+	 * does, even before the window exists. The frame loop then
+	 * uploads them to the GPU, one per frame, with update_assets(),
+	 * and each one is used as soon as asset_ready() says so; the
+	 * loading scene shows until the atlas is in.
+	 *
+	 * Builds without threads (such as Web builds without Emscripten
+	 * pthreads) decode one asset per frame instead.
+	 *
+	 * The time from start_assets() to the first frame the player
+	 * can interact with is logged, see mark_interactive_frame().
+	 */
+
+	/* ---------------------------------------------------------------------- */
+	/* Constants.                                                             */
+	/* ---------------------------------------------------------------------- */
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+	#define ASSETS_THREADS 1
+#else
+	#define ASSETS_THREADS 0
+#endif
+
+	/* Assets, in decoding order: what the first frames need first. */
+	#define ASSET_ATLAS      0
+	#define ASSET_ICON       1
+	#define ASSET_BACKGROUND 2
+	#define ASSET_COUNT      3
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern void start_assets(void);
+	extern void update_assets(void);
+	extern void wait_assets(void);
+	extern void finish_assets(void);
+	extern bool asset_ready(int asset);
+	extern int assets_done(void);
+	extern Texture2D asset_texture(int asset);
+	extern void mark_interactive_frame(void);
+
+#endif /* ASSETS_H. */
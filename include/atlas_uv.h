@@ -0,0 +1,28 @@
+/* Generated by tools/atlas_pack.c, do not edit. */
+
+#ifndef ATLAS_UV_H
+#define ATLAS_UV_H
+
+	#define ATLAS_FILE   "resources/atlas.png"
+	#define ATLAS_WIDTH  256
+	#define ATLAS_HEIGHT 256
+
+	/* Sprites. */
+	#define SPRITE_CRYSTAL  0
+	#define SPRITE_ACCEPT   1
+	#define SPRITE_DENY     2
+	#define SPRITE_GEAR     3
+	#define SPRITE_MONITOR  4
+	#define SPRITE_USER     5
+	#define SPRITE_COUNT    6
+
+	/* Sprite rectangles (x, y, width, height), in pixels. */
+	#define ATLAS_RECTS \
+		{   0,   0,  70, 110 }, \
+		{  96,   0,  50,  50 }, \
+		{ 176,   0,  50,  50 }, \
+		{ 160, 128,  30,  30 }, \
+		{   0, 128,  50,  50 }, \
+		{  80, 128,  50,  50 }
+
+#endif /* ATLAS_UV_H. */
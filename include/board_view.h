@@ -0,0 +1,96 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BOARD_VIEW_H
+#define BOARD_VIEW_H
+
+	#include <stdbool.h>
+	#include "raylib.h"
+
+	/*
+	 * Board view.
+	 *
+	 * A camera over the board (in world coordinates, which are the
+	 * screen ones at zoom 1), shown in a screen area. Boards that
+	 * fit the area are drawn as is; larger ones can be scrolled
+	 * and zoomed:
+	 * - Desktop/Web: mouse wheel zooms (around the pointer), right
+	 *   or middle button drags, arrows scroll and +/- zoom.
+	 * - Android: two-finger drag and pinch.
+	 *
+	 * Below 'badge_zoom' (BOARD_BADGE_ZOOM by default), rows should
+	 * be drawn collapsed (see board_view_badges()).
+	 */
+
+	/* Zoom limits. */
+	#define BOARD_MIN_ZOOM   0.005f
+	#define BOARD_MAX_ZOOM   1.0f
+	#define BOARD_BADGE_ZOOM 0.35f
+
+	/*
+	 * Keyboard scroll speed (screen pixels/s) and zoom steps; a
+	 * scroll step covers BOARD_KEY_MAX_DT seconds at most.
+	 */
+	#define BOARD_KEY_SPEED  600.0f
+	#define BOARD_KEY_MAX_DT 0.1f
+	#define BOARD_ZOOM_STEP  1.25f
+
+	/* ---------------------------------------------------------------------- */
+	/* Data structures.                                                       */
+	/* ---------------------------------------------------------------------- */
+
+	/*
+	 * Board view.
+	 */
+	struct board_view
+	{
+		Camera2D camera;
+		Rectangle view;      /* Screen area.                     */
+		Rectangle bounds;    /* Board, in world coordinates.     */
+		float min_zoom;      /* Whole board visible.             */
+		float badge_zoom;    /* Rows collapse below.             */
+		bool scrollable;     /* Board larger than the view.      */
+
+		/* Dragging/pinching. */
+		bool dragging;
+		Vector2 drag_last;
+		float pinch_last;
+	};
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern void init_board_view(struct board_view *v, Rectangle view,
+		Rectangle bounds);
+	extern bool update_board_view(struct board_view *v);
+	extern Rectangle board_view_visible(const struct board_view *v);
+	extern bool board_view_pointer(const struct board_view *v, Vector2 pos,
+		Vector2 *world);
+	extern bool board_view_badges(const struct board_view *v);
+	extern void board_view_focus(struct board_view *v, Rectangle rect);
+	extern void begin_board_view(const struct board_view *v);
+	extern void end_board_view(const struct board_view *v);
+
+#endif /* BOARD_VIEW_H. */
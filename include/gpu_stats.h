@@ -0,0 +1,101 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GPU_STATS_H
+#define GPU_STATS_H
+
+	/*
+	 * Per-frame GPU work counters: draw calls, texture binds,
+	 * vertices and batch flushes, per scene.
+	 *
+	 * The rlgl entry points used by raylib's shapes, text and
+	 * textures modules (and by us) are wrapped at link time
+	 * (-Wl,--wrap, see GPU_STATS_WRAP in the makefiles), and the
+	 * rlgl batching is mirrored on top of them: a new draw call
+	 * starts when the texture or the primitive mode changes, and
+	 * all of them are issued on a flush (EndDrawing(), texture
+	 * and blend mode changes, full batch).
+	 *
+	 * Only built with PROFILE=1 on platforms whose linker supports
+	 * --wrap (Linux and Android), which defines GPU_STATS;
+	 * otherwise the markers below compile to nothing.
+	 */
+
+	/* Scenes. */
+	#define GPU_SCENE_NONE    -1 /* Not counted: debug overlays. */
+	#define GPU_SCENE_TUTORIAL 0
+	#define GPU_SCENE_INGAME   1
+	#define GPU_SCENE_GEAR     2
+	#define GPU_SCENES         3
+
+	/*
+	 * Counters.
+	 */
+	struct gpu_counters
+	{
+		unsigned long draw_calls;
+		unsigned long texture_binds;
+		unsigned long vertices;
+		unsigned long flushes;
+	};
+
+#if defined(GPU_STATS)
+	/*
+	 * Count the work submitted within the scope as @p scene's:
+	 *
+	 *   GPU_SCOPE(GPU_SCENE_GEAR)
+	 *   {
+	 *       ...
+	 *   }
+	 *
+	 * Queued sprites count when flushed.
+	 */
+	#define GPU_SCOPE(scene) \
+		for (int gpu_prev_ = gpu_scene(scene), gpu_scope_ = 1; gpu_scope_; \
+			gpu_scope_ = (gpu_scene(gpu_prev_), 0))
+
+	#define GPU_FRAME_END() gpu_frame_end()
+	#define GPU_OVERLAY()   draw_gpu_stats()
+
+	/* Draw call issued outside the rlgl batch (e.g: instanced). */
+	#define GPU_DIRECT_DRAW(vertices) gpu_direct_draw(vertices)
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern const char *const gpu_scene_names[GPU_SCENES];
+	extern int gpu_scene(int scene);
+	extern void gpu_direct_draw(unsigned long vertices);
+	extern void gpu_frame_end(void);
+	extern void gpu_totals(struct gpu_counters *totals);
+	extern void draw_gpu_stats(void);
+#else
+	#define GPU_SCOPE(scene)
+	#define GPU_FRAME_END() ((void)0)
+	#define GPU_OVERLAY()   ((void)0)
+	#define GPU_DIRECT_DRAW(vertices) ((void)0)
+#endif
+
+#endif /* GPU_STATS_H. */
@@ -0,0 +1,55 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef IDLE_H
+#define IDLE_H
+
+	#include <stdbool.h>
+
+	/*
+	 * Idle mode.
+	 *
+	 * When nothing is animating and no input arrived for a few
+	 * frames, the game stops rendering until the next input: on
+	 * desktop the loop blocks waiting for window events, on Web the
+	 * Emscripten main loop is paused, and resumed by input or tab
+	 * visibility events. Android is unaffected.
+	 *
+	 * The wait can be bounded, so that timed work (such as the
+	 * scene resource unloads, see scene_mgr.h) still happens.
+	 */
+
+	/* Quiet frames before going idle. */
+	#define IDLE_FRAMES 3
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern void init_idle(void);
+	extern bool idle_update(bool busy);
+	extern void idle_wait(double timeout);
+	extern float frame_time(void);
+
+#endif /* IDLE_H. */
@@ -0,0 +1,123 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INSTANCES_H
+#define INSTANCES_H
+
+	#include <stdbool.h>
+	#include "raylib.h"
+
+	/*
+	 * Instanced sprites.
+	 *
+	 * Draws many copies of a single atlas sprite in one draw call:
+	 * the per-copy position, alpha and selection state live in an
+	 * instance buffer, and only the instances that changed since
+	 * the last draw are uploaded.
+	 *
+	 * Needs OpenGL 3.3 (desktop); on GLES2 (Android, Web) and if
+	 * the shader fails to build, init_instances() fails, and the
+	 * sprites must be drawn with the sprite batch (sprites.h).
+	 */
+#if !defined(ANDROID) && !defined(WEB)
+	#define INSTANCING
+#endif
+
+	/* Tint of the selected instances (LIGHT_BLUE). */
+	#define INSTANCE_SELECTED_TINT ((Color){176, 222, 255, 255})
+
+	/* ---------------------------------------------------------------------- */
+	/* Data structures.                                                       */
+	/* ---------------------------------------------------------------------- */
+
+	/*
+	 * Instance attributes, as uploaded.
+	 */
+	struct sprite_instance
+	{
+		float x;
+		float y;
+		float alpha;
+		float selected;
+	};
+
+	/*
+	 * Instanced sprite.
+	 */
+	struct sprite_instances
+	{
+		int sprite;
+		struct sprite_instance *data;
+		int max;
+		int dirty_lo;        /* Changed instances: [lo, hi). */
+		int dirty_hi;
+
+		/* GPU side. */
+		unsigned vao;
+		unsigned quad_vbo;
+		unsigned vbo;
+		Shader shader;
+		int loc_mvp;
+		int loc_rect;
+		int loc_size;
+	};
+
+	/* ---------------------------------------------------------------------- */
+	/* Inline routines.                                                       */
+	/* ---------------------------------------------------------------------- */
+
+	/**
+	 * Set the instance @p i, marking it for upload if it changed.
+	 */
+	static inline void set_instance(struct sprite_instances *si, int i,
+		float x, float y, float alpha, bool selected)
+	{
+		struct sprite_instance *in = &si->data[i];
+
+		if (in->x == x && in->y == y && in->alpha == alpha &&
+			in->selected == (float)selected)
+		{
+			return;
+		}
+
+		in->x        = x;
+		in->y        = y;
+		in->alpha    = alpha;
+		in->selected = (float)selected;
+
+		if (i < si->dirty_lo)
+			si->dirty_lo = i;
+		if (i >= si->dirty_hi)
+			si->dirty_hi = i + 1;
+	}
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern int init_instances(struct sprite_instances *si, int sprite, int max);
+	extern void finish_instances(struct sprite_instances *si);
+	extern void draw_instances(struct sprite_instances *si, int count);
+
+#endif /* INSTANCES_H. */
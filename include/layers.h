@@ -0,0 +1,82 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LAYERS_H
+#define LAYERS_H
+
+	#include <stdint.h>
+	#include "raylib.h"
+
+	/*
+	 * Cached layers.
+	 *
+	 * A layer keeps what rarely changes (background, panels, static
+	 * texts...) in a render texture, so that each frame only draws
+	 * it as a single textured quad. The layer is only rebuilt when
+	 * its key, built from everything its content depends on (with
+	 * layer_key()), changes.
+	 *
+	 * Layers are opaque: the content must fill the whole rectangle
+	 * (e.g: start with the background), as the layer replaces what
+	 * is below it.
+	 */
+
+	/* ---------------------------------------------------------------------- */
+	/* Data structures.                                                       */
+	/* ---------------------------------------------------------------------- */
+
+	/*
+	 * Layer.
+	 */
+	struct layer
+	{
+		RenderTexture2D target;
+		Rectangle rect;      /* Screen area.               */
+		uint64_t key;        /* Key of the current build.  */
+		int valid;
+		unsigned rebuilds;   /* Statistics.                */
+	};
+
+	/* ---------------------------------------------------------------------- */
+	/* Inline routines.                                                       */
+	/* ---------------------------------------------------------------------- */
+
+	/**
+	 * Mix @p value into the layer key @p key (FNV-1a style).
+	 */
+	static inline uint64_t layer_key(uint64_t key, uint64_t value)
+	{
+		return ((key ^ value) * 0x100000001B3ULL);
+	}
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern void init_layer(struct layer *l, Rectangle rect);
+	extern void finish_layer(struct layer *l);
+	extern void invalidate_layer(struct layer *l);
+	extern void draw_layer(struct layer *l, uint64_t key, void (*draw)(void));
+
+#endif /* LAYERS_H. */
@@ -0,0 +1,117 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MEM_STATS_H
+#define MEM_STATS_H
+
+	#include <stdbool.h>
+	#include <stddef.h>
+	#include "scene_mgr.h"
+
+	/*
+	 * Memory accounting.
+	 *
+	 * The resource loads (textures, font, board, AI...) report what
+	 * they allocate and release with mem_alloc()/mem_free(), by
+	 * category and by owner (the scene that loaded it, or shared),
+	 * and whether it lives in the process heap, in the GPU (MEM_GPU)
+	 * or in a file mapping (MEM_MAPPED): on Web, only the former
+	 * comes out of the fixed Emscripten heap (TOTAL_MEMORY, see
+	 * platforms/Makefile.Web). File mappings are paged in and out
+	 * by the OS, so they only show in their own counter and their
+	 * owner's, out of the category and heap budgets.
+	 * The high-water marks are kept, for each of them and for each
+	 * scene (while it is the current one, see mem_set_scene()).
+	 *
+	 * Going over a budget logs a warning, and makes the scene
+	 * manager release its unused resources right away, instead of
+	 * after the unload delay (see mem_over_budget()). The heap
+	 * budget can be changed with '-M <MiB>', and any of them with
+	 * '-B <name>=<MiB>' (a category name, 'heap' or 'gpu').
+	 *
+	 * All the counters are logged on exit; with 'make PROFILE=1',
+	 * F5 toggles an overlay with them (F6 logs them, on Web).
+	 */
+
+	/* ---------------------------------------------------------------------- */
+	/* Constants.                                                             */
+	/* ---------------------------------------------------------------------- */
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+	#define MEM_THREADS 1
+#else
+	#define MEM_THREADS 0
+#endif
+
+	/* Categories. */
+	#define MEM_TEXTURES   0 /* Images, textures and render targets. */
+	#define MEM_FONTS      1 /* SDF font and text cache.             */
+	#define MEM_GAME       2 /* Board and crystal instances.         */
+	#define MEM_ENGINE     3 /* MCTS arena and tablebase indexing.   */
+	#define MEM_CATEGORIES 4
+
+	/* Category flags: GPU memory or file mapping, not in the heap. */
+	#define MEM_GPU    0x100
+	#define MEM_MAPPED 0x200
+
+	/* Owners: the scenes, or none in particular. */
+	#define MEM_SHARED (SCENE_COUNT)
+	#define MEM_OWNERS (SCENE_COUNT + 1)
+
+	/* Default budgets, in bytes (0: none). */
+	#define MEM_MIB(n)           ((size_t)(n) << 20)
+	#define MEM_BUDGET_TEXTURES  MEM_MIB(32)
+	#define MEM_BUDGET_FONTS     MEM_MIB(4)
+	#define MEM_BUDGET_GAME      MEM_MIB(16)
+	#define MEM_BUDGET_ENGINE    MEM_MIB(16)
+	#define MEM_BUDGET_GPU       MEM_MIB(64)
+
+	/*
+	 * Heap: 3/4 of the 64 MiB Web heap, the rest is left to raylib,
+	 * libc and the stacks.
+	 */
+	#define MEM_BUDGET_HEAP      MEM_MIB(48)
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern void mem_alloc(int category, int owner, size_t bytes);
+	extern void mem_free(int category, int owner, size_t bytes);
+	extern size_t mem_pixels_size(int width, int height, int mipmaps,
+		int format);
+	extern void mem_set_scene(int scene);
+	extern int mem_parse_budget(const char *arg);
+	extern void mem_set_heap_budget(size_t bytes);
+	extern bool mem_over_budget(void);
+	extern void dump_mem_stats(void);
+
+#if defined(PROFILE)
+	#define MEM_OVERLAY() draw_mem_stats()
+	extern void draw_mem_stats(void);
+#else
+	#define MEM_OVERLAY() ((void)0)
+#endif
+
+#endif /* MEM_STATS_H. */
@@ -0,0 +1,99 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIM_H
+#define NIM_H
+
+	#include <stddef.h>
+	#include <stdint.h>
+
+	/*
+	 * Headless Nim engine: rules and solver, without any dependency
+	 * on raylib, so that it can be used both by the game scenes and
+	 * by offline tools.
+	 */
+
+	/* ---------------------------------------------------------------------- */
+	/* Constants.                                                             */
+	/* ---------------------------------------------------------------------- */
+
+	/* SIMD levels, see nim_simd_select(). */
+	#define NIM_SIMD_AUTO   -1
+	#define NIM_SIMD_SCALAR  0
+	#define NIM_SIMD_SSE2    1
+	#define NIM_SIMD_AVX2    2
+	#define NIM_SIMD_WASM    3
+
+	/* ---------------------------------------------------------------------- */
+	/* Data structures.                                                       */
+	/* ---------------------------------------------------------------------- */
+
+	/*
+	 * Nim position.
+	 *
+	 * The heaps are not owned by the position, i.e: the caller is
+	 * free to point it to whatever storage it likes (such as the
+	 * game 'sticks' array), with any amount of heaps.
+	 */
+	struct nim_position
+	{
+		uint64_t *heaps;
+		size_t    nheaps;
+	};
+
+	/*
+	 * Nim move: remove 'amount' (>= 1) elements from the heap
+	 * 'heap'.
+	 */
+	struct nim_move
+	{
+		size_t   heap;
+		uint64_t amount;
+	};
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern uint64_t nim_sum(const struct nim_position *pos);
+	extern uint64_t nim_remaining(const struct nim_position *pos);
+	extern int nim_is_over(const struct nim_position *pos);
+	extern int nim_is_legal(const struct nim_position *pos,
+		const struct nim_move *move);
+
+	extern int nim_first_move(const struct nim_position *pos,
+		struct nim_move *move);
+	extern int nim_next_move(const struct nim_position *pos,
+		struct nim_move *move);
+	extern int nim_apply_move(struct nim_position *pos,
+		const struct nim_move *move);
+
+	extern int nim_is_winning(const struct nim_position *pos);
+	extern int nim_best_move(const struct nim_position *pos,
+		struct nim_move *move);
+
+	extern int nim_simd_select(int level);
+	extern const char *nim_simd_name(void);
+
+#endif /* NIM_H. */
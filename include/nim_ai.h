@@ -0,0 +1,127 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIM_AI_H
+#define NIM_AI_H
+
+	#include <stddef.h>
+	#include <stdint.h>
+	#include "nim.h"
+
+	/*
+	 * Asynchronous AI jobs.
+	 *
+	 * A job (a position and a 'think' routine) is posted and runs
+	 * on a worker thread, while the caller (i.e: the frame loop)
+	 * polls for its result. Posting a new job or canceling the
+	 * current one discards any result not yet polled.
+	 *
+	 * Builds without threads (such as Web builds without Emscripten
+	 * pthreads) run the job synchronously at post time.
+	 */
+
+	/* ---------------------------------------------------------------------- */
+	/* Constants.                                                             */
+	/* ---------------------------------------------------------------------- */
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+	#define NIM_AI_THREADS 1
+	#include <pthread.h>
+#else
+	#define NIM_AI_THREADS 0
+#endif
+
+	/* Poll results. */
+	#define NIM_AI_IDLE     0 /* No job posted.                 */
+	#define NIM_AI_BUSY     1 /* Job still running.             */
+	#define NIM_AI_DONE     2 /* Job finished, move available.  */
+	#define NIM_AI_NO_MOVE  3 /* Job finished, no move found.   */
+
+	/* ---------------------------------------------------------------------- */
+	/* Data structures.                                                       */
+	/* ---------------------------------------------------------------------- */
+
+	/*
+	 * Think routine: chooses a move for 'pos' and returns 0, or
+	 * returns -1 if there is none.
+	 *
+	 * Long searches should check nim_ai_cancelled() from time
+	 * to time, and give up if it returns 1.
+	 */
+	typedef int (*nim_ai_think)(const struct nim_position *pos,
+		struct nim_move *move, void *arg);
+
+	/*
+	 * Job buffer: position and think routine.
+	 */
+	struct nim_ai_job
+	{
+		uint64_t *heaps;
+		size_t cap;
+		struct nim_position pos;
+		nim_ai_think think;
+		void *arg;
+	};
+
+	/*
+	 * AI worker.
+	 */
+	struct nim_ai
+	{
+#if NIM_AI_THREADS
+		pthread_t thread;
+		pthread_mutex_t mutex;
+		pthread_cond_t cond;
+		int quit;
+#endif
+		/* Posted (not started yet) and running jobs. */
+		struct nim_ai_job jobs[2];
+		struct nim_ai_job *pending;
+		struct nim_ai_job *running;
+		int has_pending;
+		int is_running;
+
+		/* Ids: last job posted (or canceled) and job running. */
+		unsigned posted;
+		unsigned running_id;
+
+		/* Result of the last job, if 'available'. */
+		struct nim_move move;
+		int result;
+		int available;
+	};
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern int nim_ai_init(struct nim_ai *ai);
+	extern void nim_ai_finish(struct nim_ai *ai);
+	extern int nim_ai_post(struct nim_ai *ai, const struct nim_position *pos,
+		nim_ai_think think, void *arg);
+	extern int nim_ai_poll(struct nim_ai *ai, struct nim_move *move);
+	extern void nim_ai_cancel(struct nim_ai *ai);
+	extern int nim_ai_cancelled(struct nim_ai *ai);
+
+#endif /* NIM_AI_H. */
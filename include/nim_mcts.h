@@ -0,0 +1,120 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIM_MCTS_H
+#define NIM_MCTS_H
+
+	#include <stddef.h>
+	#include <stdint.h>
+	#include "nim.h"
+	#include "nim_rand.h"
+
+	/*
+	 * Monte Carlo tree search opponent (misère Nim).
+	 *
+	 * Plain UCT with random rollouts, plus 'MCTS-Solver' style
+	 * proven wins/losses, so that small boards are solved exactly
+	 * once the search budget is enough. The nodes are expanded with
+	 * progressive widening, a random untried move at a time, so
+	 * large boards are explored over all their heaps. Tree nodes live in an arena
+	 * allocated once, and reused by every search.
+	 */
+
+	/* ---------------------------------------------------------------------- */
+	/* Constants.                                                             */
+	/* ---------------------------------------------------------------------- */
+
+	/* Default arena size, in nodes. */
+	#define NIM_MCTS_DEFAULT_NODES (1 << 16)
+
+	/* Transposition table size, in entries (power of 2). */
+	#define NIM_MCTS_TABLE_SIZE (1 << 16)
+
+	/* Difficulty levels. */
+	#define NIM_MCTS_EASY   0
+	#define NIM_MCTS_MEDIUM 1
+	#define NIM_MCTS_HARD   2
+	#define NIM_MCTS_LEVELS 3
+
+	/* ---------------------------------------------------------------------- */
+	/* Data structures.                                                       */
+	/* ---------------------------------------------------------------------- */
+
+	/*
+	 * Search budget: the search stops at whichever comes first.
+	 * A zero value means no limit (but not both).
+	 */
+	struct nim_mcts_budget
+	{
+		uint64_t iterations;
+		double seconds;
+	};
+
+	struct mcts_node;
+	struct mcts_entry;
+
+	/*
+	 * MCTS opponent.
+	 */
+	struct nim_mcts
+	{
+		/* Node arena. */
+		struct mcts_node *nodes;
+		size_t max_nodes;
+		size_t count;
+
+		/* Transposition table of proven positions. */
+		struct mcts_entry *table;
+		size_t table_mask;
+		uint32_t generation;  /* Current search, see mcts.c. */
+
+		/* Scratch: heaps and non-empty heaps, for the rollouts. */
+		uint64_t *heaps;
+		size_t *nonempty;
+		size_t cap;
+
+		struct nim_mcts_budget budget;
+		struct nim_rand rng;
+
+		/* Optional cancellation check, polled during the search. */
+		int (*stop)(void *arg);
+		void *stop_arg;
+
+		/* Statistics of the last search. */
+		uint64_t iterations;
+	};
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern int nim_mcts_init(struct nim_mcts *mcts, size_t max_nodes,
+		uint64_t seed);
+	extern void nim_mcts_free(struct nim_mcts *mcts);
+	extern size_t nim_mcts_memory(const struct nim_mcts *mcts);
+	extern void nim_mcts_set_level(struct nim_mcts *mcts, int level);
+	extern int nim_mcts_best_move(struct nim_mcts *mcts,
+		const struct nim_position *pos, struct nim_move *move);
+
+#endif /* NIM_MCTS_H. */
@@ -0,0 +1,85 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIM_RAND_H
+#define NIM_RAND_H
+
+	#include <stddef.h>
+	#include <stdint.h>
+
+	/*
+	 * Seedable pseudo-random number generator: xoshiro256**.
+	 *
+	 * Each thread should own a generator, seeded from a value drawn
+	 * from a parent one (see tools/nim_tourney.c).
+	 */
+
+	/* ---------------------------------------------------------------------- */
+	/* Data structures.                                                       */
+	/* ---------------------------------------------------------------------- */
+
+	/*
+	 * Generator state.
+	 */
+	struct nim_rand
+	{
+		uint64_t s[4];
+	};
+
+	/* ---------------------------------------------------------------------- */
+	/* Inline routines.                                                       */
+	/* ---------------------------------------------------------------------- */
+
+	/**
+	 * Returns the next 64-bit value of @p r.
+	 */
+	static inline uint64_t nim_rand_next(struct nim_rand *r)
+	{
+		uint64_t result;
+		uint64_t t;
+
+		result = r->s[1] * 5;
+		result = ((result << 7) | (result >> 57)) * 9;
+		t = r->s[1] << 17;
+
+		r->s[2] ^= r->s[0];
+		r->s[3] ^= r->s[1];
+		r->s[1] ^= r->s[2];
+		r->s[0] ^= r->s[3];
+		r->s[2] ^= t;
+		r->s[3] = (r->s[3] << 45) | (r->s[3] >> 19);
+		return (result);
+	}
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern void nim_rand_seed(struct nim_rand *r, uint64_t seed);
+	extern uint64_t nim_rand_range(struct nim_rand *r, uint64_t lo,
+		uint64_t hi);
+	extern void nim_rand_boards(struct nim_rand *r, uint64_t *heaps,
+		size_t nboards, size_t nheaps, uint64_t lo, uint64_t hi);
+
+#endif /* NIM_RAND_H. */
@@ -0,0 +1,117 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIM_SG_H
+#define NIM_SG_H
+
+	#include <stddef.h>
+	#include <stdint.h>
+	#include "nim.h"
+
+	/*
+	 * Sprague-Grundy engine, for (normal play) subtraction and octal
+	 * games played on the same rows as Nim.
+	 *
+	 * An octal game is described by its code, '0.d1d2d3...', where
+	 * the digit dk tells how k elements can be removed from a heap:
+	 *
+	 * - bit 0 (1): if that takes the whole heap.
+	 * - bit 1 (2): if that leaves one (non-empty) heap.
+	 * - bit 2 (4): if that leaves two (non-empty) heaps, i.e: the
+	 *   elements are taken from the middle of the row.
+	 *
+	 * For example: Kayles is 0.77, Dawson's chess is 0.137, and a
+	 * subtraction game with set S has dk = 3 for every k in S.
+	 *
+	 * The Grundy values are memoized up to a given limit, and every
+	 * finite octal game found to be periodic (checked with the
+	 * Guy-Smith periodicity theorem) answers queries for any heap
+	 * size in O(1).
+	 */
+
+	/* ---------------------------------------------------------------------- */
+	/* Constants.                                                             */
+	/* ---------------------------------------------------------------------- */
+
+	/* Max amount of octal digits. */
+	#define NIM_SG_MAX_DIGITS 64
+
+	/* Default amount of values to compute while looking for a period. */
+	#define NIM_SG_DEFAULT_LIMIT 4096
+
+	/* ---------------------------------------------------------------------- */
+	/* Data structures.                                                       */
+	/* ---------------------------------------------------------------------- */
+
+	/*
+	 * Grundy engine for a single game.
+	 */
+	struct nim_sg
+	{
+		/* Game. */
+		uint8_t digits[NIM_SG_MAX_DIGITS + 1];
+		size_t ndigits;
+		int nim;
+
+		/* Memoized values, g(0) to g(count - 1). */
+		uint64_t *values;
+		size_t count;
+
+		/* Periodicity, if period != 0: g(n + period) = g(n), n >= preperiod. */
+		size_t preperiod;
+		size_t period;
+	};
+
+	/*
+	 * Octal game move: remove 'amount' elements from heap 'heap',
+	 * leaving 'left' elements on its left side and the remaining
+	 * ones on its right side.
+	 */
+	struct nim_sg_move
+	{
+		size_t heap;
+		uint64_t amount;
+		uint64_t left;
+	};
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern int nim_sg_init_octal(struct nim_sg *sg, const char *code,
+		size_t limit);
+	extern int nim_sg_init_subtraction(struct nim_sg *sg,
+		const uint64_t *set, size_t nset, size_t limit);
+	extern void nim_sg_init_nim(struct nim_sg *sg);
+	extern void nim_sg_free(struct nim_sg *sg);
+
+	extern int nim_sg_value(const struct nim_sg *sg, uint64_t heap,
+		uint64_t *value);
+	extern int nim_sg_position_value(const struct nim_sg *sg,
+		const struct nim_position *pos, uint64_t *scratch, uint64_t *value);
+	extern int nim_sg_best_move(const struct nim_sg *sg,
+		const struct nim_position *pos, uint64_t *scratch,
+		struct nim_sg_move *move);
+
+#endif /* NIM_SG_H. */
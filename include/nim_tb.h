@@ -0,0 +1,120 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIM_TB_H
+#define NIM_TB_H
+
+	#include <stddef.h>
+	#include <stdint.h>
+	#include "nim.h"
+
+	/*
+	 * Tablebases: exhaustively solved Nim variants.
+	 *
+	 * A tablebase holds one bit (win/loss for the player to move)
+	 * for every position with up to 'max_heaps' non-empty heaps of
+	 * up to 'max_size' elements. Positions are indexed by their
+	 * canonical form (heaps sorted), so the order of the heaps
+	 * does not matter.
+	 *
+	 * Tablebases are generated offline (see tools/nim_tbgen.c) and
+	 * memory-mapped by nim_tb_open().
+	 */
+
+	/* ---------------------------------------------------------------------- */
+	/* Constants.                                                             */
+	/* ---------------------------------------------------------------------- */
+
+	/* File format. */
+	#define NIM_TB_MAGIC       "NIMTB01"
+	#define NIM_TB_HEADER_SIZE 64
+
+	/* Limits. */
+	#define NIM_TB_MAX_HEAPS     32
+	#define NIM_TB_MAX_SIZE      (1ULL << 24)
+	#define NIM_TB_MAX_POSITIONS (1ULL << 40)
+
+	/* ---------------------------------------------------------------------- */
+	/* Data structures.                                                       */
+	/* ---------------------------------------------------------------------- */
+
+	/*
+	 * Nim variant.
+	 *
+	 * 'take_mask' restricts the amounts that can be removed in a
+	 * single move: bit n-1 set means that n elements can be
+	 * removed. 0 means any amount (standard Nim).
+	 *
+	 * If 'misere' is set, the player that cannot move (i.e: the
+	 * other player did the last move), wins.
+	 */
+	struct nim_variant
+	{
+		uint64_t take_mask;
+		int misere;
+	};
+
+	/* Standard misère Nim: the variant played by the game. */
+	#define NIM_VARIANT_STANDARD ((struct nim_variant){0, 1})
+
+	/*
+	 * Tablebase.
+	 */
+	struct nim_tb
+	{
+		struct nim_variant variant;
+		size_t max_heaps;
+		uint64_t max_size;
+		uint64_t positions;
+		const uint8_t *bits;
+
+		/* Binomial coefficients, used for indexing. */
+		uint64_t *binom;
+
+		/* Mapping. */
+		void *map;
+		size_t map_size;
+	};
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern int nim_variant_allows(const struct nim_variant *variant,
+		uint64_t amount);
+
+	extern int nim_tb_generate(const char *path,
+		const struct nim_variant *variant, size_t max_heaps,
+		uint64_t max_size);
+
+	extern int nim_tb_open(struct nim_tb *tb, const char *path);
+	extern void nim_tb_close(struct nim_tb *tb);
+	extern size_t nim_tb_memory(const struct nim_tb *tb);
+
+	extern int nim_tb_probe(const struct nim_tb *tb,
+		const struct nim_position *pos);
+	extern int nim_tb_best_move(const struct nim_tb *tb,
+		const struct nim_position *pos, struct nim_move *move);
+
+#endif /* NIM_TB_H. */
@@ -0,0 +1,91 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+	/*
+	 * Frame-time profiler.
+	 *
+	 * Only built with 'make PROFILE=1' (which defines PROFILE);
+	 * otherwise all the markers below compile to nothing.
+	 *
+	 * Each frame is split in phases, timed with PROF_SCOPE():
+	 *
+	 *   PROF_SCOPE(PROF_LOGIC)
+	 *   {
+	 *       ...
+	 *   }
+	 *
+	 * (do not leave the scope with return/goto/break, the phase
+	 * would not be closed). The last PROF_HISTORY frames are kept
+	 * in a ring buffer, shown in an overlay (toggled with F3), and
+	 * dumped as CSV on exit (F4 on Web, to the console).
+	 */
+
+	/* Phases. */
+	#define PROF_LOGIC   0  /* Scene logic.                 */
+	#define PROF_LAYER   1  /* Cached layer (and rebuilds). */
+	#define PROF_SCENE   2  /* Scene drawing.               */
+	#define PROF_PRESENT 3  /* EndDrawing(): swap, vsync.   */
+	#define PROF_PHASES  4
+
+	/* Frames kept. */
+	#define PROF_HISTORY 1024
+
+	/* CSV dump. */
+	#define PROF_CSV_FILE "profile.csv"
+
+#if defined(PROFILE)
+	#define PROF_SCOPE(phase) \
+		for (int prof_scope_ = (prof_begin(phase), 1); prof_scope_; \
+			prof_scope_ = (prof_end(phase), 0))
+
+	#define PROF_INIT()        init_profiler()
+	#define PROF_FINISH()      finish_profiler()
+	#define PROF_FRAME_BEGIN() prof_frame_begin()
+	#define PROF_FRAME_END()   prof_frame_end()
+	#define PROF_OVERLAY()     draw_profiler()
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern void init_profiler(void);
+	extern void finish_profiler(void);
+	extern void prof_begin(int phase);
+	extern void prof_end(int phase);
+	extern void prof_frame_begin(void);
+	extern void prof_frame_end(void);
+	extern void draw_profiler(void);
+#else
+	#define PROF_SCOPE(phase)
+	#define PROF_INIT()        ((void)0)
+	#define PROF_FINISH()      ((void)0)
+	#define PROF_FRAME_BEGIN() ((void)0)
+	#define PROF_FRAME_END()   ((void)0)
+	#define PROF_OVERLAY()     ((void)0)
+#endif
+
+#endif /* PROFILER_H. */
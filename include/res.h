@@ -0,0 +1,78 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef RES_H
+#define RES_H
+
+	#include <stddef.h>
+	#include "raylib.h"
+
+	/*
+	 * Embedded resources.
+	 *
+	 * The files under resources/ that the game loads are compiled
+	 * into the binary (see tools/res_embed.c), so loading them
+	 * needs no file system at all: no working directory dependency
+	 * on desktop and no virtual file system on Web.
+	 */
+
+	/* Blob types. */
+	#define RES_PIXELS 0 /* Deflated pixels, in 'format', all mipmaps. */
+	#define RES_FILE   1 /* File contents, as is.                      */
+
+	/*
+	 * Embedded resource, named after its path, e.g:
+	 * "resources/atlas.png".
+	 *
+	 * A resource may have several entries (e.g: GPU compressed and
+	 * plain), best first: the loader uses the first one the GPU
+	 * supports.
+	 */
+	struct res_entry
+	{
+		const char *name;
+		int type;
+		int format;
+		int width;
+		int height;
+		int mipmaps;
+		int raw_size;
+		const unsigned char *data;
+		size_t size;
+	};
+
+	/* Generated table, see res_data.c. */
+	extern const struct res_entry res_entries[];
+	extern const int res_count;
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern int find_res(const char *name, int from);
+	extern Image load_res(int entry);
+	extern Texture2D upload_res(int entry, Image img);
+	extern Image load_res_image(const char *name);
+
+#endif /* RES_H. */
@@ -0,0 +1,88 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SCENE_MGR_H
+#define SCENE_MGR_H
+
+	#include <stdbool.h>
+	#include <stdint.h>
+
+	/*
+	 * Scene manager.
+	 *
+	 * Each scene has enter/exit hooks and a list of the resources it
+	 * needs (board, AI worker, tablebase...). The resources are
+	 * reference counted: they are loaded when the first scene that
+	 * uses them is entered, and released once no scene has used them
+	 * for 'scene_unload_delay' seconds, so that going back and forth
+	 * between scenes does not reload anything, but an idle game does
+	 * not keep them resident either: even when the game is idle
+	 * (see idle.h), as the wait is bounded by scene_unload_timeout().
+	 * When over the memory budget (see mem_stats.h), the unused
+	 * resources are released right away.
+	 *
+	 * Scene changes requested with change_scene() are deferred to the
+	 * start of the next update_scene_logic(), so that a scene never
+	 * exits in the middle of its own frame.
+	 */
+
+	/* ---------------------------------------------------------------------- */
+	/* Constants.                                                             */
+	/* ---------------------------------------------------------------------- */
+
+	/* Scenes. */
+	#define SCENE_LOADING  0
+	#define SCENE_TUTORIAL 1
+	#define SCENE_INGAME   2
+	#define SCENE_COUNT    3
+
+	/* Scene resources. */
+	#define SCENE_RES_BOARD     0 /* Board, view and crystal instances. */
+	#define SCENE_RES_AI        1 /* AI worker and MCTS arena.          */
+	#define SCENE_RES_TABLEBASE 2 /* Optional tablebase mapping.        */
+	#define SCENE_RES_COUNT     3
+
+	/* Default time (seconds) an unused resource is kept loaded. */
+	#define SCENE_UNLOAD_DELAY 30.0
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern double scene_unload_delay;
+
+	extern void init_scenes(int scene);
+	extern void finish_scenes(void);
+	extern void change_scene(int scene);
+	extern int current_scene(void);
+	extern int active_scene(void);
+	extern void update_scene_logic(void);
+	extern void update_scene_drawing(void);
+	extern uint64_t scene_layer_key(uint64_t key);
+	extern void draw_scene_layer(void);
+	extern bool scene_is_busy(void);
+	extern double scene_unload_timeout(void);
+	extern int scene_gpu_scene(void);
+
+#endif /* SCENE_MGR_H. */
@@ -25,18 +25,20 @@
 #ifndef SCENES_H
 #define SCENES_H
 
+	#include <stdint.h>
+	#include "nim_rand.h"
 	#include "raylib.h"
 
 	/* ---------------------------------------------------------------------- */
 	/* Constants.                                                             */
 	/* ---------------------------------------------------------------------- */
 	
-	/* Screen. */
-#if !defined(WEB)
+	/*
+	 * Screen: target frame rate, not used on Web (the browser sets
+	 * it). Animations are time-based (see tween.h), so the game
+	 * looks the same whatever the frame rate.
+	 */
 	#define FPS 60
-#else
-	#define FPS GetFPS()
-#endif
 
 #if defined(ANDROID)
 	#if defined(AR_19_9)
@@ -72,6 +74,12 @@
 	#define TUTORIAL_USER_X  (START_X + 220)
 	#define TUTORIAL_USER_Y  (TUTORIAL_PC_Y)
 
+	/* Loading progress bar. */
+	#define LOADING_X      (START_X)
+	#define LOADING_Y      (START_Y + 40)
+	#define LOADING_WIDTH  300
+	#define LOADING_HEIGHT 16
+
 	/* Ingame. */
 	#define CRYSTAL_X       (START_X)
 	#define CRYSTAL_Y       (START_Y - 18)
@@ -79,22 +87,33 @@
 	/* Colors. */
 	#define LIGHT_BLUE ((Color){176, 222, 255, 255})
 
-	/* Game state. */
-	#define STATE_TUTORIAL 0
-	#define STATE_INGAME   1
-	#define STATE_FINISH   2
-
-	/* Sticks. */
-	#define DEFAULT_STICKS    16
-	#define MAX_STICKS_PER_ROW 7
-	#define MAX_ROWS           4
-	#define MAX_STICKS        (MAX_STICKS_PER_ROW * MAX_ROWS)
-	
+	/*
+	 * Sticks.
+	 *
+	 * Default board dimensions, the actual ones are runtime
+	 * parameters ('-r rows -m max'): see 'sticks_rows' and
+	 * 'sticks_per_row'. Boards that do not fit the screen can be
+	 * scrolled and zoomed, see board_view.h.
+	 */
+	#define DEFAULT_ROWS           4
+	#define DEFAULT_STICKS_PER_ROW 7
+	#define MAX_ROWS               4096
+	#define MAX_STICKS_PER_ROW     65536
 
 	/* Turns. */
 	#define PLAYER_TURN   0
 	#define COMPUTER_TURN 1
 
+	/*
+	 * Computer difficulty: the first levels are the MCTS levels
+	 * (see nim_mcts.h), 'perfect' uses the closed-form solver.
+	 */
+	#define AI_EASY     0
+	#define AI_MEDIUM   1
+	#define AI_HARD     2
+	#define AI_PERFECT  3
+	#define AI_LEVELS   4
+
 	/**
 	 * Triggers a compile time error if the expression
 	 * evaluates to 0.
@@ -114,31 +133,51 @@
 	/* ---------------------------------------------------------------------- */
 
 	/* Common. */
-	extern int sticks[MAX_ROWS];
+	extern uint64_t *sticks;
+	extern int sticks_rows;
+	extern int sticks_per_row;
 	extern int sticks_count;
-	extern int global_state;
+	extern uint64_t game_seed;
+	extern struct nim_rand game_rand;
 	extern Vector2 mouse;
 	extern int turn;
 	extern bool cb_rnd_amt_selected;
+	extern int ai_difficulty;
 
 	/* Gear. */
 	extern void init_gear(void);
-	extern void finish_gear(void);
 	extern void update_gear_logic(void);
 	extern void update_gear_drawing(void);
+	extern void set_gear_window(bool open);
+	extern uint64_t gear_layer_key(uint64_t key);
+	extern void draw_gear_layer(void);
+
+	/* Loading. */
+	extern void update_loading_logic(void);
+	extern void update_loading_drawing(void);
 
 	/* Tutorial. */
-	extern void init_tutorial(void);
-	extern void finish_tutorial(void);
+	extern void enter_tutorial(void);
 	extern void update_tutorial_logic(void);
 	extern void update_tutorial_drawing(void);
+	extern uint64_t tutorial_layer_key(uint64_t key);
+	extern void draw_tutorial_layer(void);
 
 	/* Ingame. */
 	extern void setup_crystals_amount(void);
-	extern void init_ingame(void);
-	extern void finish_ingame(void);
+	extern int load_ingame_board(void);
+	extern void unload_ingame_board(void);
+	extern int load_ingame_ai(void);
+	extern void unload_ingame_ai(void);
+	extern int load_ingame_tablebase(void);
+	extern void unload_ingame_tablebase(void);
+	extern void enter_ingame(void);
+	extern void exit_ingame(void);
 	extern void update_ingame_logic(void);
 	extern void update_ingame_drawing(void);
+	extern bool ingame_is_busy(void);
+	extern uint64_t ingame_layer_key(uint64_t key);
+	extern void draw_ingame_layer(void);
 
 	/* IsClick. */
 	static inline bool IsClick(void)
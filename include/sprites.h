@@ -0,0 +1,55 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SPRITES_H
+#define SPRITES_H
+
+	#include "raylib.h"
+	#include "atlas_uv.h"
+
+	/*
+	 * Sprite batch.
+	 *
+	 * All the game sprites live in a single texture atlas (see
+	 * tools/atlas_pack.c and atlas_uv.h), streamed in at startup
+	 * (see assets.h). draw_sprite() only queues
+	 * the sprite; the queue is sent as a single draw call by
+	 * flush_sprites(), which must be called before drawing anything
+	 * that should appear on top of the queued sprites, and at the
+	 * end of the frame.
+	 */
+
+	/* Max queued sprites before an implicit flush. */
+	#define SPRITE_QUEUE_MAX 1024
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern Rectangle sprite_rect(int sprite);
+	extern Texture2D sprite_atlas(void);
+	extern void draw_sprite(int sprite, int x, int y, Color tint);
+	extern void flush_sprites(void);
+
+#endif /* SPRITES_H. */
@@ -0,0 +1,62 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+	#include <stdint.h>
+	#include "raylib.h"
+
+	/*
+	 * Cached text layout.
+	 *
+	 * draw_text() and measure_text() work like DrawText() and
+	 * MeasureText(), with the default font, but the glyph quads of
+	 * each (text, size) are laid out once and kept in a small
+	 * cache, so drawing an unchanged text only emits its quads.
+	 *
+	 * Texts from TEXT_SDF_MIN_SIZE on are drawn with a signed
+	 * distance field version of the default font (built at start),
+	 * so they stay sharp whatever the size.
+	 */
+
+	/* Cache slots (direct mapped) and max cached text length. */
+	#define TEXT_CACHE_SLOTS 64
+	#define TEXT_MAX_LEN     256
+
+	/* SDF font: upscale of the default font, and distance spread. */
+	#define TEXT_SDF_MIN_SIZE 30
+	#define TEXT_SDF_SCALE     4
+	#define TEXT_SDF_SPREAD    4
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern void init_text_cache(void);
+	extern void finish_text_cache(void);
+	extern void draw_text(const char *text, int x, int y, int size, Color color);
+	extern int measure_text(const char *text, int size);
+
+#endif /* TEXT_CACHE_H. */
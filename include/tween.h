@@ -0,0 +1,101 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TWEEN_H
+#define TWEEN_H
+
+	/*
+	 * Delta-time tweens.
+	 *
+	 * Animations are driven by time, not frames: the frame time is
+	 * accumulated by a tween_clock and consumed in fixed steps of
+	 * TWEEN_STEP seconds, so that they look the same at any frame
+	 * rate.
+	 */
+
+	/* ---------------------------------------------------------------------- */
+	/* Constants.                                                             */
+	/* ---------------------------------------------------------------------- */
+
+	/* Fixed timestep, in seconds. */
+	#define TWEEN_HZ   240
+	#define TWEEN_STEP (1.0f/TWEEN_HZ)
+
+	/*
+	 * Tolerance, in seconds, for the float rounding of the frame
+	 * and step times, so that the durations come out frame-exact.
+	 */
+	#define TWEEN_EPSILON 1e-6
+
+	/* Longest frame time accounted (avoids jumps after stalls). */
+	#define TWEEN_MAX_FRAME 0.25f
+
+	/* Easing curves. */
+	#define EASE_LINEAR      0
+	#define EASE_IN_QUAD     1
+	#define EASE_OUT_QUAD    2
+	#define EASE_IN_OUT_QUAD 3
+	#define EASE_OUT_CUBIC   4
+
+	/* Modes. */
+	#define TWEEN_ONCE      0
+	#define TWEEN_PING_PONG 1
+
+	/* ---------------------------------------------------------------------- */
+	/* Data structures.                                                       */
+	/* ---------------------------------------------------------------------- */
+
+	/*
+	 * Single value animation, from 'from' to 'to'.
+	 */
+	struct tween
+	{
+		float from;
+		float to;
+		float duration;
+		double elapsed;
+		int ease;
+		int mode;
+		int done;
+	};
+
+	/*
+	 * Fixed timestep accumulator.
+	 */
+	struct tween_clock
+	{
+		double acc;
+	};
+
+	/* ---------------------------------------------------------------------- */
+	/* External declarations.                                                 */
+	/* ---------------------------------------------------------------------- */
+
+	extern void tween_start(struct tween *t, float from, float to,
+		float duration, int ease, int mode);
+	extern int tween_update(struct tween *t, float dt);
+	extern float tween_value(const struct tween *t);
+	extern int tween_clock_steps(struct tween_clock *c, float frame_time);
+
+#endif /* TWEEN_H. */
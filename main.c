@@ -22,64 +22,100 @@
  * SOFTWARE.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "scenes.h"
+#include "assets.h"
+#include "gpu_stats.h"
+#include "idle.h"
+#include "layers.h"
+#include "mem_stats.h"
+#include "profiler.h"
+#include "scene_mgr.h"
+#include "sprites.h"
+#include "text_cache.h"
 
 #if defined(WEB)
     #include <emscripten/emscripten.h>
 #endif
 
-/* Game state. */
-int global_state = STATE_TUTORIAL;
-
 /* Inter-state variables. */
 Vector2 mouse;
 
 /* Game vars. */
-int sticks[MAX_ROWS] = {1, 3, 5, 7};
-int sticks_count     = MAX_STICKS;
+uint64_t *sticks;
+int sticks_rows    = DEFAULT_ROWS;
+int sticks_per_row = DEFAULT_STICKS_PER_ROW;
+int sticks_count;
+
+/*
+ * Random generator for the boards (and the computer), seeded from
+ * the command line ('-s seed') so that games can be replayed.
+ */
+uint64_t game_seed;
+struct nim_rand game_rand;
 
 /* Turn. */
 int turn;
 
-/* Images. */
-Texture2D back;
-
-/* Program icon. */
-Image icon;
+/*
+ * Screen layer: background, title and the static parts of the
+ * current scene, see layers.h.
+ */
+static struct layer screen_layer;
 
 /**
  * Draw game title.
  */
 static inline void draw_title(void)
 {
-	DrawText(TITLE, START_X, 0, TITLE_SIZE, BLACK);
-	DrawText("by Theldus", START_X + MeasureText(TITLE, TITLE_SIZE) + 10, 30,
+	draw_text(TITLE, START_X, 0, TITLE_SIZE, BLACK);
+	draw_text("by Theldus", START_X + measure_text(TITLE, TITLE_SIZE) + 10, 30,
 		TITLE_BY_SIZE, BLACK);
 }
 
 /**
- * Update logic and drawing for each frame
+ * Draw the screen layer content.
  */
-static INLINE void update_frame(void)
+static void draw_screen_layer(void)
+{
+	/* Plain background while the image streams in. */
+	if (asset_ready(ASSET_BACKGROUND))
+		DrawTexture(asset_texture(ASSET_BACKGROUND), 0, 0, WHITE);
+	else
+		DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, RAYWHITE);
+
+	draw_title();
+	draw_scene_layer();
+}
+
+/**
+ * Returns the screen layer key: changes whenever its content
+ * should.
+ */
+static uint64_t screen_layer_key(void)
+{
+	uint64_t key = layer_key(0, asset_ready(ASSET_BACKGROUND));
+	return (scene_layer_key(key));
+}
+
+/**
+ * Update logic and drawing for a single frame.
+ */
+static INLINE void run_frame(void)
 {
 	/* ----------------------------------------------------------------- */
 	/* Update logic                                                      */
 	/* ----------------------------------------------------------------- */
-	mouse = GetMousePosition();
+	PROF_FRAME_BEGIN();
 
-	switch (global_state)
+	PROF_SCOPE(PROF_LOGIC)
 	{
-		case STATE_TUTORIAL:
-			update_tutorial_logic();
-			break;
-
-		case STATE_INGAME:
-			update_ingame_logic();
-			break;
-
-		default:
-			break;
+		mouse = GetMousePosition();
+		update_assets();
+		update_scene_logic();
 	}
 
 	/* ----------------------------------------------------------------- */
@@ -87,59 +123,182 @@ static INLINE void update_frame(void)
 	/* ----------------------------------------------------------------- */
 	BeginDrawing();
 
-		ClearBackground(BLACK);
-		DrawTexture(back, 0, 0, WHITE);
+		GPU_SCOPE(scene_gpu_scene())
+		{
+			/* Background, title and static parts, cached. */
+			PROF_SCOPE(PROF_LAYER)
+			{
+				ClearBackground(BLACK);
+				draw_layer(&screen_layer, screen_layer_key(),
+					draw_screen_layer);
+			}
 
-		/* Draw title. */
-		draw_title();
+			PROF_SCOPE(PROF_SCENE)
+			{
+				update_scene_drawing();
 
-		switch (global_state)
-		{
-			case STATE_TUTORIAL:
-				update_tutorial_drawing();
-				break;
+				/* Sprites still queued. */
+				flush_sprites();
+			}
+		}
+
+		PROF_OVERLAY();
+		GPU_OVERLAY();
+		MEM_OVERLAY();
+
+	PROF_SCOPE(PROF_PRESENT)
+	{
+		EndDrawing();
+	}
+
+	if (active_scene() != SCENE_LOADING)
+		mark_interactive_frame();
 
-			case STATE_INGAME:
-				update_ingame_drawing();
-				break;
+	PROF_FRAME_END();
+	GPU_FRAME_END();
+}
 
-			default:
-				break;
+/**
+ * Update logic and drawing for each frame
+ */
+static INLINE void update_frame(void)
+{
+	run_frame();
+
+	/* Nothing going on: stop rendering until the next input. */
+	if (idle_update(assets_done() < ASSET_COUNT || scene_is_busy()))
+		idle_wait(scene_unload_timeout());
+}
+
+#if defined(GPU_STATS)
+/**
+ * Headless benchmark: runs @p frames frames of each scene in a
+ * hidden window, and prints the GPU work per frame, per scene, as
+ * CSV. The screen layer is rebuilt every frame, so that all the
+ * geometry is counted, not only the uncached one.
+ */
+static void benchmark(int frames)
+{
+	static const char *const runs[] = {"tutorial", "gear", "ingame"};
+	struct gpu_counters before[GPU_SCENES];
+	struct gpu_counters after[GPU_SCENES];
+	int run;
+	int s;
+	int i;
+
+	wait_assets();
+	printf("run,scene,draw_calls,texture_binds,vertices,flushes\n");
+
+	for (run = 0; run < 3; run++)
+	{
+		set_gear_window(run == 1);
+		turn = PLAYER_TURN;
+		change_scene(run == 2 ? SCENE_INGAME : SCENE_TUTORIAL);
+
+		gpu_totals(before);
+		for (i = 0; i < frames; i++)
+		{
+			invalidate_layer(&screen_layer);
+			run_frame();
 		}
+		gpu_totals(after);
 
-	EndDrawing();
+		for (s = 0; s < GPU_SCENES; s++)
+		{
+			if (after[s].vertices == before[s].vertices)
+				continue;
+
+			printf("%s,%s,%.1f,%.1f,%.1f,%.1f\n", runs[run],
+				gpu_scene_names[s],
+				(double)(after[s].draw_calls - before[s].draw_calls) / frames,
+				(double)(after[s].texture_binds - before[s].texture_binds) /
+					frames,
+				(double)(after[s].vertices - before[s].vertices) / frames,
+				(double)(after[s].flushes - before[s].flushes) / frames);
+		}
+	}
 }
+#endif
 
 /**
  * Main game loop.
  */
-int main(void)
+int main(int argc, char **argv)
 {
+	int bench_frames = 0;
+	int i;
+
+	/* Decode the assets while the window is being created. */
+	start_assets();
+
+	game_seed = (uint64_t)time(NULL);
+	for (i = 1; i + 1 < argc; i += 2)
+	{
+		if (!strcmp(argv[i], "-s"))
+			game_seed = strtoull(argv[i + 1], NULL, 0);
+		else if (!strcmp(argv[i], "-r"))
+			sticks_rows = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-m"))
+			sticks_per_row = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-u"))
+			scene_unload_delay = atof(argv[i + 1]);
+		else if (!strcmp(argv[i], "-M"))
+			mem_set_heap_budget(MEM_MIB(atoi(argv[i + 1])));
+		else if (!strcmp(argv[i], "-B") && mem_parse_budget(argv[i + 1]) < 0)
+			TraceLog(LOG_WARNING, "Invalid budget %s, expected <name>=<MiB>",
+				argv[i + 1]);
+#if defined(GPU_STATS)
+		else if (!strcmp(argv[i], "-b"))
+			bench_frames = atoi(argv[i + 1]);
+#endif
+	}
+	nim_rand_seed(&game_rand, game_seed);
+
+	if (sticks_rows < 1 || sticks_rows > MAX_ROWS ||
+		sticks_per_row < 1 || sticks_per_row > MAX_STICKS_PER_ROW)
+	{
+		TraceLog(LOG_WARNING, "Invalid board %dx%d (max: %dx%d), using %dx%d",
+			sticks_rows, sticks_per_row, MAX_ROWS, MAX_STICKS_PER_ROW,
+			DEFAULT_ROWS, DEFAULT_STICKS_PER_ROW);
+		sticks_rows    = DEFAULT_ROWS;
+		sticks_per_row = DEFAULT_STICKS_PER_ROW;
+	}
+
+	if (bench_frames > 0)
+		SetConfigFlags(FLAG_WINDOW_HIDDEN);
+
 	InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, TITLE);
+	TraceLog(LOG_INFO, "Random seed: %llu", (unsigned long long)game_seed);
 
 #if !defined(WEB)
-	SetTargetFPS(FPS);
+	if (!bench_frames)
+		SetTargetFPS(FPS);
 #endif
 
-	back = LoadTexture("resources/crystals.jpg");
-	icon = LoadImage("resources/crystal.png");
-	SetWindowIcon(icon);
+	init_text_cache();
+	init_layer(&screen_layer, (Rectangle){.x = 0, .y = 0,
+		.width = SCREEN_WIDTH, .height = SCREEN_HEIGHT});
+	init_scenes(SCENE_LOADING);
+	init_idle();
+	PROF_INIT();
 
-	init_gear();
-	init_tutorial();
-	init_ingame();
+#if defined(GPU_STATS)
+	if (bench_frames > 0)
+		benchmark(bench_frames);
+#endif
 
 #if !defined(WEB)
-	while (!WindowShouldClose())
+	while (!bench_frames && !WindowShouldClose())
 		update_frame();
 #else
 	emscripten_set_main_loop(update_frame, 0, 1);
 #endif
 
-	finish_ingame();
-	finish_tutorial();
-	finish_gear();
-	UnloadTexture(back);
-	UnloadImage(icon);
+	PROF_FINISH();
+	finish_scenes();
+	finish_text_cache();
+	finish_layer(&screen_layer);
+	finish_assets();
+	dump_mem_stats();
 	CloseWindow();
 }
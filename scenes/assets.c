@@ -0,0 +1,379 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <time.h>
+#include "raylib.h"
+#include "assets.h"
+#include "atlas_uv.h"
+#include "mem_stats.h"
+#include "res.h"
+
+#if ASSETS_THREADS
+	#include <pthread.h>
+	static pthread_t decoder;
+	static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+	static bool decoder_running;
+	#define LOCK()   pthread_mutex_lock(&mutex)
+	#define UNLOCK() pthread_mutex_unlock(&mutex)
+#else
+	#define LOCK()
+	#define UNLOCK()
+#endif
+
+/* Asset states. */
+#define ASSET_PENDING 0 /* Not decoded yet.             */
+#define ASSET_DECODED 1 /* Decoded, waiting for upload. */
+#define ASSET_READY   2 /* Uploaded (and usable).       */
+#define ASSET_FAILED  3 /* Unable to decode.            */
+
+/*
+ * Asset lifecycle:
+ * The decoder only touches ASSET_PENDING assets, moving them to
+ * ASSET_DECODED (or ASSET_FAILED), and the frame loop only the
+ * ASSET_DECODED ones, so the lock only guards the state changes.
+ */
+static struct asset
+{
+	const char *name;
+	int entry;
+	Image img;
+	Texture2D tex;
+	int state;
+} assets[ASSET_COUNT] = {
+	[ASSET_ATLAS]      = {.name = ATLAS_FILE},
+	[ASSET_ICON]       = {.name = "resources/crystal.png"},
+	[ASSET_BACKGROUND] = {.name = "resources/crystals.jpg"},
+};
+
+/* Startup time. */
+static struct timespec start;
+static bool interactive;
+
+/**
+ * Returns the time elapsed since start_assets(), in ms.
+ */
+static double elapsed_ms(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((now.tv_sec - start.tv_sec) * 1e3 +
+		(now.tv_nsec - start.tv_nsec) / 1e6);
+}
+
+/**
+ * Account the image @p img (if any) loaded, or released if
+ * @p loaded is false.
+ */
+static void account_image(Image img, bool loaded)
+{
+	size_t size;
+
+	if (!img.data)
+		return;
+
+	size = mem_pixels_size(img.width, img.height, img.mipmaps, img.format);
+	if (loaded)
+		mem_alloc(MEM_TEXTURES, MEM_SHARED, size);
+	else
+		mem_free(MEM_TEXTURES, MEM_SHARED, size);
+}
+
+/**
+ * Account the texture @p tex (if any), see account_image().
+ */
+static void account_texture(Texture2D tex, bool loaded)
+{
+	size_t size;
+
+	if (!tex.id)
+		return;
+
+	size = mem_pixels_size(tex.width, tex.height, tex.mipmaps, tex.format);
+	if (loaded)
+		mem_alloc(MEM_TEXTURES|MEM_GPU, MEM_SHARED, size);
+	else
+		mem_free(MEM_TEXTURES|MEM_GPU, MEM_SHARED, size);
+}
+
+/**
+ * Returns the state of @p asset.
+ */
+static int asset_state(int asset)
+{
+	int state;
+	LOCK();
+		state = assets[asset].state;
+	UNLOCK();
+	return (state);
+}
+
+/**
+ * Decode the asset @p a: its best version (see res.h), or the
+ * uncompressed one for the icon.
+ */
+static void decode(struct asset *a)
+{
+	Image img;
+
+	a->entry = find_res(a->name, 0);
+	if (a == &assets[ASSET_ICON] || a->entry < 0)
+	{
+		a->entry = -1;
+		img = load_res_image(a->name);
+	}
+	else
+		img = load_res(a->entry);
+
+	account_image(img, true);
+
+	LOCK();
+		a->img   = img;
+		a->state = img.data ? ASSET_DECODED : ASSET_FAILED;
+	UNLOCK();
+
+	if (!img.data)
+		TraceLog(LOG_WARNING, "Unable to decode asset %s", a->name);
+}
+
+#if ASSETS_THREADS
+/**
+ * Decoder thread routine.
+ */
+static void *decoder_thread(void *arg)
+{
+	int i;
+	((void)arg);
+
+	for (i = 0; i < ASSET_COUNT; i++)
+		decode(&assets[i]);
+
+	return (NULL);
+}
+#endif
+
+/**
+ * Upload the (decoded) asset @p a; if the GPU does not support
+ * its format, the next version is decoded and tried, here.
+ */
+static void upload(struct asset *a)
+{
+	if (a == &assets[ASSET_ICON])
+		SetWindowIcon(a->img);
+	else
+	{
+		for (;;)
+		{
+			a->tex = upload_res(a->entry, a->img);
+			if (a->tex.id || a->entry < 0)
+				break;
+
+			/* Format not supported: next version. */
+			a->entry = find_res(a->name, a->entry + 1);
+			if (a->entry < 0)
+				break;
+
+			account_image(a->img, false);
+			UnloadImage(a->img);
+			a->img = load_res(a->entry);
+			account_image(a->img, true);
+		}
+		account_texture(a->tex, true);
+	}
+
+	if (a == &assets[ASSET_ATLAS] &&
+		(a->tex.width != ATLAS_WIDTH || a->tex.height != ATLAS_HEIGHT))
+	{
+		TraceLog(LOG_WARNING, "Atlas %s does not match atlas_uv.h",
+			ATLAS_FILE);
+	}
+
+	account_image(a->img, false);
+	UnloadImage(a->img);
+	a->img.data = NULL;
+
+	LOCK();
+		a->state = ASSET_READY;
+	UNLOCK();
+
+	TraceLog(LOG_INFO, "Asset %s ready in %.1f ms", a->name, elapsed_ms());
+}
+
+/**
+ * Start decoding the assets: the earlier, the better, i.e: the
+ * first thing in main().
+ */
+void start_assets(void)
+{
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+#if ASSETS_THREADS
+	decoder_running = !pthread_create(&decoder, NULL, decoder_thread, NULL);
+	if (!decoder_running)
+		TraceLog(LOG_WARNING, "Unable to create the decoder thread");
+#endif
+}
+
+/**
+ * Upload the next decoded asset, if any; called once per frame.
+ *
+ * Without the decoder thread, decode the next one instead.
+ */
+void update_assets(void)
+{
+	int state;
+	int i;
+
+#if ASSETS_THREADS
+	/*
+	 * Decoder done (it decodes in order): detach it, so its worker
+	 * goes back to the pool on Web, for the computer thread.
+	 */
+	if (decoder_running && asset_state(ASSET_COUNT - 1) != ASSET_PENDING)
+	{
+		pthread_detach(decoder);
+		decoder_running = false;
+	}
+#endif
+
+	for (i = 0; i < ASSET_COUNT; i++)
+	{
+		state = asset_state(i);
+		if (state == ASSET_DECODED)
+		{
+			upload(&assets[i]);
+			return;
+		}
+
+#if ASSETS_THREADS
+		if (state == ASSET_PENDING && decoder_running)
+			return;
+#endif
+		if (state == ASSET_PENDING)
+		{
+			decode(&assets[i]);
+			return;
+		}
+	}
+}
+
+/**
+ * Load all the remaining assets, blocking.
+ */
+void wait_assets(void)
+{
+	struct timespec ts = {.tv_sec = 0, .tv_nsec = 1000000};
+
+	while (assets_done() < ASSET_COUNT)
+	{
+		update_assets();
+#if ASSETS_THREADS
+		nanosleep(&ts, NULL);
+#else
+		((void)ts);
+#endif
+	}
+}
+
+/**
+ * Release all the assets.
+ */
+void finish_assets(void)
+{
+	int i;
+
+#if ASSETS_THREADS
+	if (decoder_running)
+		pthread_join(decoder, NULL);
+	decoder_running = false;
+#endif
+
+	for (i = 0; i < ASSET_COUNT; i++)
+	{
+		if (assets[i].state == ASSET_DECODED)
+		{
+			account_image(assets[i].img, false);
+			UnloadImage(assets[i].img);
+		}
+		else if (assets[i].state == ASSET_READY && assets[i].tex.id)
+		{
+			account_texture(assets[i].tex, false);
+			UnloadTexture(assets[i].tex);
+		}
+
+		assets[i].state = ASSET_PENDING;
+	}
+}
+
+/**
+ * Returns true if @p asset was uploaded, or will never be (it
+ * failed to decode): either way, there is nothing to wait for.
+ */
+bool asset_ready(int asset)
+{
+	int state = asset_state(asset);
+	return (state == ASSET_READY || state == ASSET_FAILED);
+}
+
+/**
+ * Returns how many assets are ready, see asset_ready().
+ */
+int assets_done(void)
+{
+	int done;
+	int i;
+
+	for (i = 0, done = 0; i < ASSET_COUNT; i++)
+		done += asset_ready(i);
+
+	return (done);
+}
+
+/**
+ * Returns the texture of @p asset: an empty one (id 0) while it
+ * is not ready.
+ */
+Texture2D asset_texture(int asset)
+{
+	Texture2D none = {0};
+
+	if (asset_state(asset) != ASSET_READY)
+		return (none);
+
+	return (assets[asset].tex);
+}
+
+/**
+ * Mark the end of a frame the player can interact with: the first
+ * one logs the time to first interactive frame.
+ */
+void mark_interactive_frame(void)
+{
+	if (interactive)
+		return;
+
+	interactive = true;
+	TraceLog(LOG_INFO, "Time to first interactive frame: %.1f ms",
+		elapsed_ms());
+}
@@ -0,0 +1,310 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <math.h>
+#include "raylib.h"
+#include "board_view.h"
+#include "idle.h"
+
+/**
+ * Keep the camera within the board (with the same margin the
+ * board has within the view), and aligned to the top-left corner
+ * in the axes where the board fits.
+ */
+static void clamp_camera(struct board_view *v)
+{
+	Camera2D *c = &v->camera;
+	float vis_w, vis_h;
+	float hi;
+
+	if (c->zoom < v->min_zoom)
+		c->zoom = v->min_zoom;
+	if (c->zoom > BOARD_MAX_ZOOM)
+		c->zoom = BOARD_MAX_ZOOM;
+
+	vis_w = v->view.width  / c->zoom;
+	vis_h = v->view.height / c->zoom;
+
+	hi = 2.0f*v->bounds.x + v->bounds.width - v->view.x - vis_w;
+	if (c->target.x > hi)
+		c->target.x = hi;
+	if (c->target.x < v->view.x)
+		c->target.x = v->view.x;
+
+	hi = 2.0f*v->bounds.y + v->bounds.height - v->view.y - vis_h;
+	if (c->target.y > hi)
+		c->target.y = hi;
+	if (c->target.y < v->view.y)
+		c->target.y = v->view.y;
+}
+
+/**
+ * Zoom by @p factor, keeping the world point under the screen
+ * position @p pos in place.
+ */
+static void zoom_at(struct board_view *v, Vector2 pos, float factor)
+{
+	Vector2 world = GetScreenToWorld2D(pos, v->camera);
+
+	v->camera.zoom *= factor;
+	if (v->camera.zoom < v->min_zoom)
+		v->camera.zoom = v->min_zoom;
+	if (v->camera.zoom > BOARD_MAX_ZOOM)
+		v->camera.zoom = BOARD_MAX_ZOOM;
+
+	v->camera.target.x = world.x - (pos.x - v->camera.offset.x) /
+		v->camera.zoom;
+	v->camera.target.y = world.y - (pos.y - v->camera.offset.y) /
+		v->camera.zoom;
+}
+
+/**
+ * Scroll by (@p dx, @p dy) screen pixels.
+ */
+static void scroll(struct board_view *v, float dx, float dy)
+{
+	v->camera.target.x += dx / v->camera.zoom;
+	v->camera.target.y += dy / v->camera.zoom;
+}
+
+#if !defined(ANDROID)
+/**
+ * Mouse and keyboard input.
+ */
+static void view_input(struct board_view *v)
+{
+	Vector2 center;
+	Vector2 pos;
+	float wheel;
+	float step;
+	float dt;
+
+	pos = GetMousePosition();
+
+	/* Zoom around the pointer. */
+	wheel = GetMouseWheelMove();
+	if (wheel != 0.0f && CheckCollisionPointRec(pos, v->view))
+		zoom_at(v, pos, powf(BOARD_ZOOM_STEP, wheel));
+
+	/* Drag. */
+	if (IsMouseButtonDown(MOUSE_RIGHT_BUTTON) ||
+		IsMouseButtonDown(MOUSE_MIDDLE_BUTTON))
+	{
+		if (v->dragging)
+			scroll(v, v->drag_last.x - pos.x, v->drag_last.y - pos.y);
+		else
+			v->dragging = CheckCollisionPointRec(pos, v->view);
+		v->drag_last = pos;
+	}
+	else
+		v->dragging = false;
+
+	/* Keyboard. */
+	dt = frame_time();
+	if (dt > BOARD_KEY_MAX_DT)
+		dt = BOARD_KEY_MAX_DT;
+	step = BOARD_KEY_SPEED * dt;
+	if (IsKeyDown(KEY_LEFT))
+		scroll(v, -step, 0.0f);
+	if (IsKeyDown(KEY_RIGHT))
+		scroll(v, step, 0.0f);
+	if (IsKeyDown(KEY_UP))
+		scroll(v, 0.0f, -step);
+	if (IsKeyDown(KEY_DOWN))
+		scroll(v, 0.0f, step);
+
+	center.x = v->view.x + v->view.width  / 2.0f;
+	center.y = v->view.y + v->view.height / 2.0f;
+	if (IsKeyPressed(KEY_EQUAL) || IsKeyPressed(KEY_KP_ADD))
+		zoom_at(v, center, BOARD_ZOOM_STEP);
+	if (IsKeyPressed(KEY_MINUS) || IsKeyPressed(KEY_KP_SUBTRACT))
+		zoom_at(v, center, 1.0f / BOARD_ZOOM_STEP);
+}
+#else
+/**
+ * Touch input: two fingers drag and pinch.
+ */
+static void view_input(struct board_view *v)
+{
+	Vector2 a, b, mid;
+	float dist;
+
+	if (GetTouchPointsCount() != 2)
+	{
+		v->dragging = false;
+		return;
+	}
+
+	a = GetTouchPosition(0);
+	b = GetTouchPosition(1);
+	mid.x = (a.x + b.x) / 2.0f;
+	mid.y = (a.y + b.y) / 2.0f;
+	dist  = hypotf(a.x - b.x, a.y - b.y);
+
+	if (v->dragging)
+	{
+		scroll(v, v->drag_last.x - mid.x, v->drag_last.y - mid.y);
+		if (v->pinch_last > 0.0f && dist > 0.0f)
+			zoom_at(v, mid, dist / v->pinch_last);
+	}
+	else
+		v->dragging = CheckCollisionPointRec(mid, v->view);
+
+	v->drag_last  = mid;
+	v->pinch_last = dist;
+}
+#endif
+
+/**
+ * Initialize the view @p v, showing the board @p bounds (world
+ * coordinates) in the screen area @p view.
+ */
+void init_board_view(struct board_view *v, Rectangle view, Rectangle bounds)
+{
+	float zw, zh;
+
+	v->view   = view;
+	v->bounds = bounds;
+	v->dragging   = false;
+	v->pinch_last = 0.0f;
+	v->badge_zoom = BOARD_BADGE_ZOOM;
+
+	/* Identity: world == screen. */
+	v->camera.offset.x = view.x;
+	v->camera.offset.y = view.y;
+	v->camera.target   = v->camera.offset;
+	v->camera.rotation = 0.0f;
+	v->camera.zoom     = 1.0f;
+
+	/* Zoom that shows the whole board (with its margins). */
+	zw = view.width  / (2.0f*(bounds.x - view.x) + bounds.width);
+	zh = view.height / (2.0f*(bounds.y - view.y) + bounds.height);
+	v->min_zoom = fminf(fminf(zw, zh), BOARD_MAX_ZOOM);
+	if (v->min_zoom < BOARD_MIN_ZOOM)
+		v->min_zoom = BOARD_MIN_ZOOM;
+
+	v->scrollable = v->min_zoom < BOARD_MAX_ZOOM;
+}
+
+/**
+ * Handle the scroll/zoom input, if the board is scrollable.
+ *
+ * Returns true if the camera moved.
+ */
+bool update_board_view(struct board_view *v)
+{
+	Camera2D prev = v->camera;
+
+	if (!v->scrollable)
+		return (false);
+
+	view_input(v);
+	clamp_camera(v);
+
+	return (prev.zoom != v->camera.zoom ||
+		prev.target.x != v->camera.target.x ||
+		prev.target.y != v->camera.target.y);
+}
+
+/**
+ * Returns the visible world area.
+ */
+Rectangle board_view_visible(const struct board_view *v)
+{
+	Rectangle r;
+	r.x      = v->camera.target.x;
+	r.y      = v->camera.target.y;
+	r.width  = v->view.width  / v->camera.zoom;
+	r.height = v->view.height / v->camera.zoom;
+	return (r);
+}
+
+/**
+ * Map the screen position @p pos to world coordinates into
+ * @p world.
+ *
+ * Returns false if @p pos is outside the view.
+ */
+bool board_view_pointer(const struct board_view *v, Vector2 pos,
+	Vector2 *world)
+{
+	if (!CheckCollisionPointRec(pos, v->view))
+		return (false);
+
+	*world = GetScreenToWorld2D(pos, v->camera);
+	return (true);
+}
+
+/**
+ * Returns true if the zoom is too low to draw (and pick) single
+ * crystals, i.e: rows should be drawn as count badges.
+ */
+bool board_view_badges(const struct board_view *v)
+{
+	return (v->camera.zoom < v->badge_zoom);
+}
+
+/**
+ * Scroll so that the world area @p rect is centered, as far as
+ * possible.
+ */
+void board_view_focus(struct board_view *v, Rectangle rect)
+{
+	Rectangle vis;
+
+	if (!v->scrollable)
+		return;
+
+	vis = board_view_visible(v);
+	v->camera.target.x = rect.x + (rect.width  - vis.width)  / 2.0f;
+	v->camera.target.y = rect.y + (rect.height - vis.height) / 2.0f;
+	clamp_camera(v);
+}
+
+/**
+ * Start drawing in world coordinates, clipped to the view; a
+ * no-op for boards that fit it.
+ */
+void begin_board_view(const struct board_view *v)
+{
+	if (!v->scrollable)
+		return;
+
+	BeginScissorMode((int)v->view.x, (int)v->view.y, (int)v->view.width,
+		(int)v->view.height);
+	BeginMode2D(v->camera);
+}
+
+/**
+ * Stop drawing in world coordinates; queued sprites must be
+ * flushed before.
+ */
+void end_board_view(const struct board_view *v)
+{
+	if (!v->scrollable)
+		return;
+
+	EndMode2D();
+	EndScissorMode();
+}
@@ -24,27 +24,39 @@
 
 #include "raylib.h"
 #include "scenes.h"
+#include "gpu_stats.h"
+#include "layers.h"
+#include "sprites.h"
+#include "text_cache.h"
 
-/* Textures. */
-static Texture2D gear;
+/* Rectangles. */
 static Rectangle rec_gear;
 static Rectangle rec_gear_window;
 static Rectangle rec_cb_click;
+static Rectangle rec_diff_click;
 static Vector2   gear_settings_vec;
 
 /* Window and Checkbox current values. */
 static bool gear_window = false;
 bool cb_rnd_amt_selected = false;
+int ai_difficulty = AI_PERFECT;
 
 /* Gear settings values. */
 #define GEAR_SETTINGS_TXT  "Settings:"
 #define GEAR_SETTINGS_SIZE 20
 #define GEAR_RND_AMT_TXT   "Random amount of crystals"
 #define GEAR_RND_AMT_SIZE  20
+#define GEAR_DIFF_TXT      "Difficulty: %s (click to change)"
+#define GEAR_DIFF_SIZE     20
+
+/* Difficulty names. */
+static const char *const difficulty_names[AI_LEVELS] = {
+	"Easy", "Medium", "Hard", "Perfect"
+};
 
 /* Gear window values. */
-#define GEAR_WINDOW_WIDTH  310
-#define GEAR_WINDOW_HEIGHT 80
+#define GEAR_WINDOW_WIDTH  330
+#define GEAR_WINDOW_HEIGHT 110
 #define GEAR_WINDOW_X ((SCREEN_WIDTH/2) - (GEAR_WINDOW_WIDTH/2))
 #define GEAR_WINDOW_Y ((SCREEN_HEIGHT/2) - (GEAR_WINDOW_HEIGHT/2))
 #define GEAR_WINDOW_PADDING_X (GEAR_WINDOW_X + 5)
@@ -60,12 +72,12 @@ bool cb_rnd_amt_selected = false;
 void init_gear(void)
 {
 	Vector2 rnd_amt_size;
+	Vector2 diff_size;
 
-	gear = LoadTexture("resources/gear.png");
 	rec_gear.x      = GEAR_X;
 	rec_gear.y      = GEAR_Y;
-	rec_gear.width  = gear.width;
-	rec_gear.height = gear.height;
+	rec_gear.width  = sprite_rect(SPRITE_GEAR).width;
+	rec_gear.height = sprite_rect(SPRITE_GEAR).height;
 
 	rec_gear_window.x      = GEAR_WINDOW_X;
 	rec_gear_window.y      = GEAR_WINDOW_Y;
@@ -82,14 +94,15 @@ void init_gear(void)
 	rec_cb_click.y      = GEAR_WINDOW_PADDING_Y + gear_settings_vec.y;
 	rec_cb_click.width  = GEAR_CB_BUTTON_OUT_SIZE + 5 + rnd_amt_size.x;
 	rec_cb_click.height = GEAR_CB_BUTTON_OUT_SIZE;
-}
 
-/**
- * Finish gear window.
- */
-void finish_gear(void)
-{
-	UnloadTexture(gear);
+	diff_size = MeasureTextEx(GetFontDefault(),
+		TextFormat(GEAR_DIFF_TXT, difficulty_names[AI_PERFECT]),
+		(float)GEAR_DIFF_SIZE, (float)GEAR_DIFF_SIZE/10);
+
+	rec_diff_click.x      = GEAR_WINDOW_PADDING_X;
+	rec_diff_click.y      = rec_cb_click.y + GEAR_CB_BUTTON_OUT_SIZE + 10;
+	rec_diff_click.width  = diff_size.x;
+	rec_diff_click.height = diff_size.y;
 }
 
 /**
@@ -106,6 +119,9 @@ void update_gear_logic(void)
 
 		else if (gear_window && CheckCollisionPointRec(mouse, rec_cb_click))
 			cb_rnd_amt_selected = !cb_rnd_amt_selected;
+
+		else if (gear_window && CheckCollisionPointRec(mouse, rec_diff_click))
+			ai_difficulty = (ai_difficulty + 1) % AI_LEVELS;
 	}
 }
 
@@ -114,14 +130,38 @@ void update_gear_logic(void)
  */
 void update_gear_drawing(void)
 {
-	DrawTexture(gear, GEAR_X, GEAR_Y, WHITE);
+	GPU_SCOPE(GPU_SCENE_GEAR)
+	{
+		draw_sprite(SPRITE_GEAR, GEAR_X, GEAR_Y, WHITE);
+	}
+}
 
-	if (!gear_window)
-		return;
+/**
+ * Open (or close) the gear window, as if clicked.
+ */
+void set_gear_window(bool open)
+{
+	gear_window = open;
+}
 
+/**
+ * Mix into @p key everything the gear window drawing depends on.
+ */
+uint64_t gear_layer_key(uint64_t key)
+{
+	key = layer_key(key, gear_window);
+	key = layer_key(key, cb_rnd_amt_selected);
+	return (layer_key(key, (uint64_t)ai_difficulty));
+}
+
+/**
+ * Draw the gear window.
+ */
+static void draw_gear_window(void)
+{
 	DrawRectangleRounded(rec_gear_window, 0.10f, 0, ColorAlpha(BLUE, 0.2f));
 	DrawRectangleRoundedLines(rec_gear_window, 0.10f, 0, 1, BLACK);
-	DrawText(GEAR_SETTINGS_TXT, GEAR_WINDOW_PADDING_X, GEAR_WINDOW_Y,
+	draw_text(GEAR_SETTINGS_TXT, GEAR_WINDOW_PADDING_X, GEAR_WINDOW_Y,
 		GEAR_SETTINGS_SIZE, BLACK);
 
 	DrawLine(GEAR_WINDOW_X, GEAR_WINDOW_Y + gear_settings_vec.y,
@@ -141,8 +181,26 @@ void update_gear_drawing(void)
 			GEAR_CB_BUTTON_INN_SIZE, GEAR_CB_BUTTON_INN_SIZE, BLACK);
 	}
 
-	DrawText(GEAR_RND_AMT_TXT,
+	draw_text(GEAR_RND_AMT_TXT,
 		GEAR_WINDOW_PADDING_X + GEAR_CB_BUTTON_OUT_SIZE + 5,
 		GEAR_WINDOW_PADDING_Y + gear_settings_vec.y,
 		GEAR_RND_AMT_SIZE, BLACK);
+
+	draw_text(TextFormat(GEAR_DIFF_TXT, difficulty_names[ai_difficulty]),
+		rec_diff_click.x, rec_diff_click.y, GEAR_DIFF_SIZE, BLACK);
+}
+
+/**
+ * Draw the gear window, if open; cached in the screen layer, as
+ * it only changes on clicks.
+ */
+void draw_gear_layer(void)
+{
+	if (!gear_window)
+		return;
+
+	GPU_SCOPE(GPU_SCENE_GEAR)
+	{
+		draw_gear_window();
+	}
 }
@@ -0,0 +1,329 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "raylib.h"
+#include "rlgl.h"
+#include "scenes.h"
+#include "gpu_stats.h"
+
+/*
+ * rlgl draw calls per batch, see DEFAULT_BATCH_DRAWCALLS in
+ * rlgl.h.
+ */
+#define BATCH_DRAWCALLS 256
+
+/* Counters: current frame, last frame and since the start. */
+static struct gpu_counters frame[GPU_SCENES];
+static struct gpu_counters last[GPU_SCENES];
+static struct gpu_counters totals[GPU_SCENES];
+
+/* Current scene. */
+static int scene = GPU_SCENE_NONE;
+
+/* Mirrored rlgl batch state. */
+static unsigned draw_texture;  /* Texture of the current draw.   */
+static int draw_mode = -1;     /* Mode of the current draw.      */
+static int draw_vertices;      /* Vertices in the current draw.  */
+static int draw_scene;         /* Scene of its first vertex.     */
+static int batch_draws;        /* Closed draws in the batch.     */
+static unsigned batch_scenes;  /* Scenes with work in the batch. */
+
+/* HUD. */
+#if defined(ANDROID)
+static bool visible = true;
+#else
+static bool visible = false;
+#endif
+
+#define HUD_WIDTH  270
+#define HUD_HEIGHT 60
+#define HUD_X      (SCREEN_WIDTH - HUD_WIDTH - 5)
+#define HUD_Y      (SCREEN_HEIGHT - HUD_HEIGHT - 5)
+#define HUD_SIZE   10
+
+const char *const gpu_scene_names[GPU_SCENES] = {
+	"tutorial", "ingame", "gear"
+};
+
+/* Real rlgl/raylib functions. */
+extern void __real_rlSetTexture(unsigned int id);
+extern void __real_rlBegin(int mode);
+extern void __real_rlVertex2f(float x, float y);
+extern void __real_rlVertex3f(float x, float y, float z);
+extern bool __real_rlCheckRenderBatchLimit(int count);
+extern void __real_BeginTextureMode(RenderTexture2D target);
+extern void __real_EndTextureMode(void);
+extern void __real_BeginBlendMode(int mode);
+extern void __real_EndBlendMode(void);
+extern void __real_BeginShaderMode(Shader shader);
+extern void __real_EndShaderMode(void);
+extern void __real_EndDrawing(void);
+extern void __real_rlDrawRenderBatchActive(void);
+
+/**
+ * Close the current draw, if it has something.
+ */
+static void close_draw(void)
+{
+	if (!draw_vertices)
+		return;
+
+	if (draw_scene != GPU_SCENE_NONE)
+	{
+		frame[draw_scene].draw_calls++;
+		batch_scenes |= 1u << draw_scene;
+	}
+
+	draw_vertices = 0;
+	batch_draws++;
+}
+
+/**
+ * The batch was drawn: count a flush for every scene with work
+ * in it, and reset the draw state as rlgl does.
+ */
+static void flushed(void)
+{
+	int s;
+
+	close_draw();
+	for (s = 0; s < GPU_SCENES; s++)
+		if (batch_scenes & (1u << s))
+			frame[s].flushes++;
+
+	batch_scenes = 0;
+	batch_draws  = 0;
+	draw_mode    = RL_QUADS;
+	draw_texture = rlGetTextureIdDefault();
+}
+
+/**
+ * Start a new draw, with the texture @p texture, flushing if
+ * the batch runs out of draws.
+ */
+static void new_draw(unsigned texture)
+{
+	close_draw();
+	if (batch_draws >= BATCH_DRAWCALLS)
+		flushed();
+
+	if (texture != draw_texture && scene != GPU_SCENE_NONE)
+		frame[scene].texture_binds++;
+
+	draw_texture = texture;
+}
+
+/**
+ * Count @p count vertices.
+ */
+static void add_vertices(int count)
+{
+	if (!draw_vertices)
+		draw_scene = scene;
+
+	draw_vertices += count;
+	if (scene != GPU_SCENE_NONE)
+		frame[scene].vertices += count;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Wrappers                                                                  */
+/* ------------------------------------------------------------------------- */
+
+void __wrap_rlSetTexture(unsigned int id)
+{
+	if (id && id != draw_texture)
+		new_draw(id);
+	__real_rlSetTexture(id);
+}
+
+void __wrap_rlBegin(int mode)
+{
+	if (mode != draw_mode)
+	{
+		draw_mode = mode;
+		new_draw(rlGetTextureIdDefault());
+	}
+	__real_rlBegin(mode);
+}
+
+void __wrap_rlVertex2f(float x, float y)
+{
+	add_vertices(1);
+	__real_rlVertex2f(x, y);
+}
+
+void __wrap_rlVertex3f(float x, float y, float z)
+{
+	add_vertices(1);
+	__real_rlVertex3f(x, y, z);
+}
+
+bool __wrap_rlCheckRenderBatchLimit(int count)
+{
+	bool flush = __real_rlCheckRenderBatchLimit(count);
+	if (flush)
+		flushed();
+	return (flush);
+}
+
+void __wrap_BeginTextureMode(RenderTexture2D target)
+{
+	flushed();
+	__real_BeginTextureMode(target);
+}
+
+void __wrap_EndTextureMode(void)
+{
+	flushed();
+	__real_EndTextureMode();
+}
+
+void __wrap_BeginBlendMode(int mode)
+{
+	flushed();
+	__real_BeginBlendMode(mode);
+}
+
+void __wrap_EndBlendMode(void)
+{
+	flushed();
+	__real_EndBlendMode();
+}
+
+void __wrap_BeginShaderMode(Shader shader)
+{
+	flushed();
+	__real_BeginShaderMode(shader);
+}
+
+void __wrap_EndShaderMode(void)
+{
+	flushed();
+	__real_EndShaderMode();
+}
+
+void __wrap_EndDrawing(void)
+{
+	flushed();
+	__real_EndDrawing();
+}
+
+void __wrap_rlDrawRenderBatchActive(void)
+{
+	flushed();
+	__real_rlDrawRenderBatchActive();
+}
+
+/* ------------------------------------------------------------------------- */
+/* Counters                                                                  */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Count the next submitted work as @p new_scene's, returns the
+ * previous scene.
+ */
+int gpu_scene(int new_scene)
+{
+	int prev = scene;
+	scene = new_scene;
+	return (prev);
+}
+
+/**
+ * Count a draw call of @p vertices vertices, with its own texture,
+ * issued outside the rlgl batch (which must be flushed before).
+ */
+void gpu_direct_draw(unsigned long vertices)
+{
+	if (scene == GPU_SCENE_NONE)
+		return;
+
+	frame[scene].draw_calls++;
+	frame[scene].texture_binds++;
+	frame[scene].vertices += vertices;
+}
+
+/**
+ * Finish the frame: its counters become the 'last' ones, shown
+ * in the HUD.
+ */
+void gpu_frame_end(void)
+{
+	int s;
+
+	for (s = 0; s < GPU_SCENES; s++)
+	{
+		totals[s].draw_calls    += frame[s].draw_calls;
+		totals[s].texture_binds += frame[s].texture_binds;
+		totals[s].vertices      += frame[s].vertices;
+		totals[s].flushes       += frame[s].flushes;
+	}
+
+	memcpy(last, frame, sizeof(last));
+	memset(frame, 0, sizeof(frame));
+
+#if !defined(ANDROID)
+	if (IsKeyPressed(KEY_F2))
+		visible = !visible;
+#endif
+}
+
+/**
+ * Copy the counters since the start, per scene, to @p out.
+ */
+void gpu_totals(struct gpu_counters *out)
+{
+	memcpy(out, totals, sizeof(totals));
+}
+
+/**
+ * Draw the HUD: last frame counters, per scene.
+ */
+void draw_gpu_stats(void)
+{
+	int prev;
+	int s;
+	int y;
+
+	if (!visible)
+		return;
+
+	prev = gpu_scene(GPU_SCENE_NONE);
+
+	DrawRectangle(HUD_X, HUD_Y, HUD_WIDTH, HUD_HEIGHT, Fade(BLACK, 0.7f));
+	DrawText("scene     draws  binds  verts  flushes", HUD_X + 5, HUD_Y + 5,
+		HUD_SIZE, YELLOW);
+
+	for (s = 0, y = HUD_Y + 5 + HUD_SIZE + 2; s < GPU_SCENES; s++,
+		y += HUD_SIZE + 2)
+	{
+		DrawText(TextFormat("%-8s %6lu %6lu %6lu %6lu", gpu_scene_names[s],
+			last[s].draw_calls, last[s].texture_binds, last[s].vertices,
+			last[s].flushes), HUD_X + 5, y, HUD_SIZE, WHITE);
+	}
+
+	gpu_scene(prev);
+}
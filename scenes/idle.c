@@ -0,0 +1,220 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "raylib.h"
+#include "scenes.h"
+#include "idle.h"
+
+#if defined(WEB)
+	#include <emscripten/emscripten.h>
+	#include <emscripten/eventloop.h>
+	#include <emscripten/html5.h>
+#elif !defined(ANDROID)
+	/* raylib links GLFW statically. */
+	extern void glfwWaitEvents(void);
+	extern void glfwWaitEventsTimeout(double timeout);
+#endif
+
+/*
+ * Idle state; 'waking' counts the frames left to correct after
+ * waking up: the logic runs before BeginDrawing(), so the idle time
+ * shows in GetFrameTime() on the second frame only.
+ */
+#define WAKE_FRAMES 2
+
+static Vector2 last_mouse;
+static int quiet_frames;
+static int waking;
+
+#if defined(WEB)
+static bool idle;
+static long wake_timeout;
+
+/**
+ * Resume the main loop, if paused.
+ */
+static void wake_up(void)
+{
+	if (!idle)
+		return;
+
+	if (wake_timeout)
+	{
+		emscripten_clear_timeout(wake_timeout);
+		wake_timeout = 0;
+	}
+
+	idle = false;
+	waking = WAKE_FRAMES;
+	quiet_frames = 0;
+	emscripten_resume_main_loop();
+}
+
+/* HTML5 event callbacks, never consume the events. */
+static EM_BOOL on_mouse(int type, const EmscriptenMouseEvent *e, void *data)
+{
+	((void)type); ((void)e); ((void)data);
+	wake_up();
+	return (EM_FALSE);
+}
+
+static EM_BOOL on_wheel(int type, const EmscriptenWheelEvent *e, void *data)
+{
+	((void)type); ((void)e); ((void)data);
+	wake_up();
+	return (EM_FALSE);
+}
+
+static EM_BOOL on_touch(int type, const EmscriptenTouchEvent *e, void *data)
+{
+	((void)type); ((void)e); ((void)data);
+	wake_up();
+	return (EM_FALSE);
+}
+
+static EM_BOOL on_key(int type, const EmscriptenKeyboardEvent *e, void *data)
+{
+	((void)type); ((void)e); ((void)data);
+	wake_up();
+	return (EM_FALSE);
+}
+
+static EM_BOOL on_visibility(int type,
+	const EmscriptenVisibilityChangeEvent *e, void *data)
+{
+	((void)type); ((void)e); ((void)data);
+	wake_up();
+	return (EM_FALSE);
+}
+
+/* Idle timeout callback. */
+static void on_timeout(void *data)
+{
+	((void)data);
+	wake_timeout = 0;
+	wake_up();
+}
+#endif
+
+/**
+ * Initialize the idle mode; on Web, registers the events that
+ * resume the main loop.
+ */
+void init_idle(void)
+{
+	last_mouse = GetMousePosition();
+
+#if defined(WEB)
+	emscripten_set_mousemove_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, NULL,
+		EM_FALSE, on_mouse);
+	emscripten_set_mousedown_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, NULL,
+		EM_FALSE, on_mouse);
+	emscripten_set_mouseup_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, NULL,
+		EM_FALSE, on_mouse);
+	emscripten_set_wheel_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, NULL,
+		EM_FALSE, on_wheel);
+	emscripten_set_touchstart_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, NULL,
+		EM_FALSE, on_touch);
+	emscripten_set_keydown_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, NULL,
+		EM_FALSE, on_key);
+	emscripten_set_visibilitychange_callback(NULL, EM_FALSE, on_visibility);
+#endif
+}
+
+/**
+ * Update the idle state at the end of a frame; @p busy tells if
+ * the current scene is animating or waiting for something other
+ * than the input (e.g: the AI).
+ *
+ * Returns true if the game should go idle, false otherwise.
+ */
+bool idle_update(bool busy)
+{
+#if defined(ANDROID)
+	((void)busy);
+	return (false);
+#else
+	Vector2 mouse_now;
+	bool input;
+
+	if (waking > 0)
+		waking--;
+	mouse_now = GetMousePosition();
+
+	input = mouse_now.x != last_mouse.x || mouse_now.y != last_mouse.y ||
+		IsMouseButtonDown(MOUSE_LEFT_BUTTON)   ||
+		IsMouseButtonDown(MOUSE_RIGHT_BUTTON)  ||
+		IsMouseButtonDown(MOUSE_MIDDLE_BUTTON) ||
+		GetMouseWheelMove() != 0.0f ||
+		GetKeyPressed() != 0 ||
+		IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_RIGHT) ||
+		IsKeyDown(KEY_UP)   || IsKeyDown(KEY_DOWN);
+
+	last_mouse = mouse_now;
+
+	if (busy || input)
+		quiet_frames = 0;
+	else if (quiet_frames < IDLE_FRAMES)
+		quiet_frames++;
+
+	return (quiet_frames >= IDLE_FRAMES);
+#endif
+}
+
+/**
+ * Wait for the next input, or at most @p timeout seconds, if
+ * positive (e.g: until the next scene resource unload): blocks on
+ * desktop, pauses the main loop on Web (it is resumed by the event
+ * callbacks, or a timer).
+ */
+void idle_wait(double timeout)
+{
+#if defined(WEB)
+	idle = true;
+	if (timeout > 0.0)
+		wake_timeout = emscripten_set_timeout(on_timeout, timeout * 1e3, NULL);
+	emscripten_pause_main_loop();
+#elif !defined(ANDROID)
+	if (timeout > 0.0)
+		glfwWaitEventsTimeout(timeout);
+	else
+		glfwWaitEvents();
+	quiet_frames = 0;
+	waking = WAKE_FRAMES;
+#else
+	((void)timeout);
+#endif
+}
+
+/**
+ * Returns the duration of the last frame, in seconds, without the
+ * time spent idle: the frames after waking up count as regular
+ * frames.
+ */
+float frame_time(void)
+{
+	if (waking > 0)
+		return (1.0f / (float)FPS);
+	return (GetFrameTime());
+}
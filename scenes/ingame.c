@@ -23,9 +23,23 @@
  */
 
 #include <assert.h>
+#include <math.h>
 #include <stdlib.h>
 #include "raylib.h"
 #include "scenes.h"
+#include "scene_mgr.h"
+#include "nim.h"
+#include "nim_tb.h"
+#include "nim_ai.h"
+#include "nim_mcts.h"
+#include "board_view.h"
+#include "idle.h"
+#include "instances.h"
+#include "layers.h"
+#include "mem_stats.h"
+#include "sprites.h"
+#include "text_cache.h"
+#include "tween.h"
 
 /* In-game states. */
 #define S_DEFAULT          0
@@ -34,21 +48,39 @@
 #define S_CONFIRM_REMOVE   4
 #define S_FADE_END         8
 #define S_FADE_PLAY_AGAIN 16
+#define S_AI_THINKING     32
 static int state;
 
-/* Frame-management + animations. */
-static int frame_counter;
-static float alpha = 0.0f;
-static float alpha_again = 0.0f;
-static float alpha_inc = 0.0f;
-static int move_start_x;
-static int move_step;
+/* Animations, time-based (see tween.h). */
+static struct tween_clock anim_clock;
+static struct tween fade;       /* Removed crystals and result text. */
+static struct tween fade_again; /* 'Play again' blinking.            */
+static struct tween shift;      /* Shifted crystals X position.      */
 
-/* In-game global vars. */
-static Texture2D crystal;
-static Texture2D accept;
-static Texture2D deny;
-static int crystal_idx = -1;
+/* Animation durations, in seconds. */
+#define REMOVE_TIME 1.0f
+#define SHIFT_TIME  1.0f
+#define FADE_TIME   0.5f
+
+/* Crystal under the pointer. */
+static int hover_row = -1;
+static int hover_col = -1;
+
+/*
+ * Optional tablebase (see tools/nim_tbgen.c), used instead of the
+ * closed-form solver for the positions it covers.
+ */
+#define TABLEBASE_FILE "resources/nim.tb"
+static struct nim_tb tablebase;
+
+/* Computer moves are searched in background, see nim_ai.h. */
+static struct nim_ai ai;
+
+/* MCTS opponent, for the non-perfect difficulties; worker only. */
+static struct nim_mcts mcts;
+static struct nim_rand mcts_rng;
+static bool mcts_seeded;
+static size_t mcts_bytes;
 
 /* Texture sizes. */
 #define CRYSTAL_WIDTH    (70)
@@ -59,20 +91,29 @@ static int crystal_idx = -1;
 #define CB_DENY_HEIGHT   (50)
 
 /*
- * Crystal click structure.
- *
- * Contains the coordinates a single crystal and the coordinates
- * inside the sticks list.
+ * Board view, at the left of the status bar: large boards can be
+ * scrolled and zoomed, only the visible crystals are drawn.
  */
-static struct crystal_click
-{
-	Rectangle rect;
-	int row;
-	int col;
-} crystal_click[MAX_STICKS];
+#define BOARD_X      0
+#define BOARD_Y      (CRYSTAL_Y)
+#define BOARD_WIDTH  (SB_X - SB_SPACE)
+#define BOARD_HEIGHT (SCREEN_HEIGHT - CRYSTAL_Y)
+static struct board_view board;
+static bool board_moving; /* Camera moved on the last frame. */
 
-/* Recalculate crystal_clicks. */
-static int recalculate_crystal_clicks = 1;
+/* Row count badges, when zoomed out. */
+#define BADGE_SIZE 10
+
+/*
+ * Crystals, drawn instanced when possible (see instances.h): as
+ * that is cheap whatever the amount, rows only collapse when the
+ * crystals are a few pixels wide, i.e: at the atlas mipmap level 4,
+ * the last one free of bleeding (see tools/atlas_pack.c).
+ */
+#define INSTANCED_BADGE_ZOOM (1.0f / 16.0f)
+static struct sprite_instances crystal_instances;
+static bool instanced;
+static int crystal_count;
 
 /* Selected crystal. */
 static int crystal_row = -1;
@@ -109,96 +150,97 @@ static Rectangle play_again_rect;
 /* Internal routines - game logic                                         */
 /* ---------------------------------------------------------------------- */
 
+/**
+ * MCTS cancellation check: stops the search as soon as the
+ * current job is cancelled.
+ */
+static int computer_cancelled(void *arg)
+{
+	return (nim_ai_cancelled(arg));
+}
+
 /**
  * Computer "AI", i.e: algorithm that chooses the best row and
- * amount to remove.
+ * amount to remove; runs on the AI worker.
+ *
+ * @p arg holds the difficulty, as of the time the job was posted.
  */
-static void computer_think(void)
+static int computer_think(const struct nim_position *pos,
+	struct nim_move *move, void *arg)
 {
-	int greater_than_one;
-	int nim_sum;
-	int amnt;
-	int i;
+	int difficulty = (int)(intptr_t)arg;
 
-	/* Ensure that we're unrolling the right amount. */
-	COMPILE_TIME_ASSERT(MAX_ROWS == 4);
-
-	/* Count amount of heaps with more than one crystal. */
-	greater_than_one = 0;
-	for (i = 0; i < MAX_ROWS; i++)
-		if (sticks[i] > 1)
-			greater_than_one++;
-
-	/* Nim sum. */
-	nim_sum = sticks[0] ^ sticks[1] ^ sticks[2] ^ sticks[3];
-
-	/*
-	 * Two options here:
-	 *
-	 * a) If nim_sum != 0, the computer _will_ win =).
-	 *
-	 * b) If nim_sum is 0, the computer have no way to create another
-	 *    sequence that has 0 as the nim_sum value, in other words:
-	 *    computer will lose if the player keeps playing like this =).
-	 */
-	if (nim_sum)
+	if (difficulty != AI_PERFECT)
 	{
-		/* Recalculate nim-sum. */
-		for (i = 0; i < MAX_ROWS; i++)
-			if ((amnt = sticks[i] ^ nim_sum) < sticks[i])
-				break;
+		nim_mcts_set_level(&mcts, difficulty);
+		return (nim_mcts_best_move(&mcts, pos, move));
+	}
 
-		/*
-		 * We have 2 options here: (again)
-		 * a) More than one heap with more than one stick
-		 * b) Exactly one heap with more than one stick
-		 *
-		 * The option b) do not conforms with the maths as
-		 * expected and we fall in a case were we remove
-		 * n or n-1 sticks from that column. So is necessary
-		 * to bifurcate these two scenarios here.
-		 */
+	if (!nim_tb_best_move(&tablebase, pos, move))
+		return (0);
 
-		/* Scenario a). */
-		if (greater_than_one != 1)
-		{
-			/* Update crystal_* vars. */
-			crystal_row = i;
-			crystal_col = (sticks[i] - amnt - 1);
-		}
+	return (nim_best_move(pos, move));
+}
 
-		/* Scenario b). */
-		else
-		{
-			/* Odd number of crystals, remove all row. */
-			if ((sticks_count - sticks[i]) & 1)
-			{
-				crystal_row = i;
-				crystal_col = (sticks[i] - 1);
-			}
+/**
+ * Post the current board to the AI worker.
+ */
+static void computer_start_thinking(void)
+{
+	struct nim_position pos;
 
-			/* Even number, remove n-1 crystals. */
-			else
-			{
-				crystal_row = i;
-				crystal_col = (sticks[i] - 2);
-			}
-		}
-	}
+	pos.heaps  = sticks;
+	pos.nheaps = sticks_rows;
+	nim_ai_post(&ai, &pos, computer_think, (void *)(intptr_t)ai_difficulty);
+}
 
-	/*
-	 * There is no way to get nin_sum == 0 here, so let us remove
-	 * a single piece and hope the player makes a wrong move.
-	 */
-	else
+/**
+ * Check if the AI worker already chose a move; if so, select
+ * the chosen crystals.
+ *
+ * Returns 1 if the computer is done thinking, 0 otherwise.
+ */
+static int computer_done_thinking(void)
+{
+	struct nim_position pos;
+	struct nim_move move;
+
+	switch (nim_ai_poll(&ai, &move))
 	{
-		for (i = 0; i < MAX_ROWS; i++)
-			if (sticks[i] > 0)
-				break;
+		case NIM_AI_DONE:
+			break;
 
-		crystal_row = i;
-		crystal_col = 0;
+		case NIM_AI_BUSY:
+			return (0);
+
+		/*
+		 * The search failed (e.g: out of memory), and would again:
+		 * use the solver, right here, instead of asking again.
+		 */
+		case NIM_AI_NO_MOVE:
+			TraceLog(LOG_WARNING, "Computer search failed, using the solver");
+			pos.heaps  = sticks;
+			pos.nheaps = sticks_rows;
+			if (nim_best_move(&pos, &move) < 0)
+				nim_first_move(&pos, &move);
+			break;
+
+		/* Lost job (should not happen), just ask again. */
+		default:
+			computer_start_thinking();
+			return (0);
 	}
+
+	/* Update crystal_* vars. */
+	crystal_row = move.heap;
+	crystal_col = move.amount - 1;
+
+	/* Show the chosen crystals. */
+	board_view_focus(&board, (Rectangle){.x = CRYSTAL_X,
+		.y = CRYSTAL_Y + crystal_row*CRYSTAL_HEIGHT,
+		.width = (crystal_col + 1)*CRYSTAL_WIDTH,
+		.height = CRYSTAL_HEIGHT});
+	return (1);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -206,23 +248,36 @@ static void computer_think(void)
 /* ---------------------------------------------------------------------- */
 
 /**
- * Draw status bar, that contains the current turn, selected row,
- * column and the confirm/deny buttons.
+ * Selected row and amount to remove (1-based), or 0 if there is
+ * no selection.
+ */
+static void status_selection(int *row, int *amt)
+{
+	*row = hover_row + 1;
+	*amt = hover_col + 1;
+}
+
+/**
+ * Returns 1 if the status bar shows the accept/deny buttons,
+ * 0 otherwise.
+ */
+static int status_has_buttons(void)
+{
+	return (state != S_AI_THINKING && crystal_row > -1 &&
+		(state == S_DEFAULT || state == S_CONFIRM_REMOVE));
+}
+
+/**
+ * Draw the status bar panel and texts (cached in the screen layer,
+ * see ingame_layer_key()).
  */
 static void draw_status_bar(void)
 {
 	Rectangle rec;
 	int row;
 	int amt;
-	int posX;
-	int posY;
 
-	row = amt = 0;
-	if (crystal_idx != -1)
-	{
-		row = crystal_click[crystal_idx].row + 1;
-		amt = crystal_click[crystal_idx].col + 1;
-	}
+	status_selection(&row, &amt);
 
 	/* Background. */
 	rec.x = SB_X;
@@ -233,8 +288,8 @@ static void draw_status_bar(void)
 	DrawRectangleRoundedLines(rec, 0.10f, 0, 1, BLACK);
 
 	/* Texts. */
-	DrawText("Status: ", SB_TITLE_X, SB_TITLE_Y, 30, BLACK);
-	DrawText(TextFormat(
+	draw_text("Status: ", SB_TITLE_X, SB_TITLE_Y, 30, BLACK);
+	draw_text(TextFormat(
 		" > Turn: %s\n"
 		" > Selected row:     %d\n"
 		" > Amount to remove: %d\n",
@@ -242,98 +297,228 @@ static void draw_status_bar(void)
 		row, amt),
 		SB_TITLE_X, SB_TITLE_Y + 50, 20, BLACK);
 
+	/* Computer still thinking. */
+	if (state == S_AI_THINKING)
+		draw_text("Thats my turn, can I play?", SB_TITLE_X, SB_TITLE_Y + 150,
+			20, BLACK);
+
 	/* Check if there is a row selected. */
-	if (crystal_row > -1 && (state == S_DEFAULT || state == S_CONFIRM_REMOVE))
+	else if (status_has_buttons())
 	{
 		if (turn == PLAYER_TURN)
-			DrawText(TextFormat("Do you really want to remove\n%d crystals "
+			draw_text(TextFormat("Do you really want to remove\n%d crystals "
 				"from row %d ?\n", amt, row), SB_TITLE_X, SB_TITLE_Y + 150,
 				20, BLACK);
 		else if (turn == COMPUTER_TURN)
-			DrawText("Thats my turn, can I play?", SB_TITLE_X, SB_TITLE_Y + 150,
+			draw_text("Thats my turn, can I play?", SB_TITLE_X, SB_TITLE_Y + 150,
 				20, BLACK);
+	}
+}
+
+/**
+ * Draw the accept/deny buttons of the status bar, if any.
+ */
+static void draw_status_buttons(void)
+{
+	int posX;
+	int posY;
+
+	if (!status_has_buttons())
+		return;
 
+	posX = CB_START_X + ((SB_WIDTH - ((CB_ACCEPT_WIDTH << 1) +
+		CB_SPACING)) >> 1);
+	posY = CB_START_Y;
 
-		posX = CB_START_X + ((SB_WIDTH - ((CB_ACCEPT_WIDTH << 1) +
-			CB_SPACING)) >> 1);
-		posY = CB_START_Y;
+	draw_sprite(SPRITE_ACCEPT, posX, posY, WHITE);
+	draw_sprite(SPRITE_DENY, posX + CB_ACCEPT_WIDTH + CB_SPACING, posY,
+		WHITE);
+}
 
-	
-		DrawTexture(accept, posX, posY, WHITE);
-		DrawTexture(deny,   posX + CB_ACCEPT_WIDTH + CB_SPACING, posY, WHITE);
+/**
+ * Visible rows [@p row0, @p row1), given the visible world area
+ * @p vis.
+ */
+static void visible_rows(const Rectangle *vis, int *row0, int *row1)
+{
+	*row0 = (int)floorf((vis->y - CRYSTAL_Y) / CRYSTAL_HEIGHT);
+	*row1 = (int)ceilf((vis->y + vis->height - CRYSTAL_Y) / CRYSTAL_HEIGHT);
+
+	if (*row0 < 0)
+		*row0 = 0;
+	if (*row1 > sticks_rows)
+		*row1 = sticks_rows;
+}
+
+/**
+ * Visible columns [@p col0, @p col1) of a row whose crystals
+ * [@p from, @p to) start at the world X @p x.
+ */
+static void visible_cols(const Rectangle *vis, int from, int to, float x,
+	int *col0, int *col1)
+{
+	*col0 = from + (int)floorf((vis->x - x) / CRYSTAL_WIDTH);
+	*col1 = from + (int)ceilf((vis->x + vis->width - x) / CRYSTAL_WIDTH);
+
+	if (*col0 < from)
+		*col0 = from;
+	if (*col1 > to)
+		*col1 = to;
+}
+
+/**
+ * Returns the most crystals (partial ones included) the board
+ * view can show, down to the zoom @p zoom.
+ */
+static int max_visible_crystals(float zoom)
+{
+	int64_t max;
+
+	max = ((int64_t)(BOARD_WIDTH  / (CRYSTAL_WIDTH  * zoom)) + 2) *
+		((int64_t)(BOARD_HEIGHT / (CRYSTAL_HEIGHT * zoom)) + 2);
+	if (max > (int64_t)sticks_rows * sticks_per_row)
+		max = (int64_t)sticks_rows * sticks_per_row;
+
+	return ((int)max);
+}
+
+/**
+ * Find the crystal at the world position @p pos, in constant time:
+ * the rows are a regular grid, and each row spans an interval
+ * given by its crystal count (so removals need no update).
+ *
+ * Returns true and fills @p row and @p col if there is one.
+ */
+static bool crystal_at(Vector2 pos, int *row, int *col)
+{
+	float r = floorf((pos.y - CRYSTAL_Y) / CRYSTAL_HEIGHT);
+	float c = floorf((pos.x - CRYSTAL_X) / CRYSTAL_WIDTH);
+
+	if (r < 0.0f || r >= (float)sticks_rows || c < 0.0f ||
+		c >= (float)sticks[(int)r])
+	{
+		return (false);
 	}
+
+	*row = (int)r;
+	*col = (int)c;
+	return (true);
 }
 
 /**
- * Draw all the remaining crystals on the screen, also does the fade
- * and shifting effect.
+ * Draw the crystal (@p row, @p col) at the world X @p x: fading
+ * when being removed, tinted when selected.
+ */
+static void draw_crystal(int row, int col, int x)
+{
+	int y = CRYSTAL_Y + row*CRYSTAL_HEIGHT;
+	float alpha;
+	bool selected;
+	Color tint;
+
+	alpha = 1.0f;
+	if (state == S_REMOVING_PIECE && crystal_row == row && col <= crystal_col)
+		alpha = tween_value(&fade);
+
+	selected = (turn == PLAYER_TURN && hover_row == row && col <= hover_col);
+
+	if (instanced)
+	{
+		if (crystal_count < crystal_instances.max)
+			set_instance(&crystal_instances, crystal_count++, (float)x,
+				(float)y, alpha, selected);
+		return;
+	}
+
+	tint = ColorAlpha(selected ? INSTANCE_SELECTED_TINT : WHITE, alpha);
+	draw_sprite(SPRITE_CRYSTAL, x, y, tint);
+}
+
+/**
+ * Draw the visible crystals [@p from, @p to) of the row @p row,
+ * the first one at the world X @p x.
+ */
+static void draw_row(const Rectangle *vis, int row, int from, int to, float x)
+{
+	int col0, col1;
+
+	visible_cols(vis, from, to, x, &col0, &col1);
+	for (int j = col0; j < col1; j++)
+		draw_crystal(row, j, (int)x + (j - from)*CRYSTAL_WIDTH);
+}
+
+/**
+ * Draw all the remaining (visible) crystals, also does the fade
+ * and shifting effect; when zoomed out, only the first crystal of
+ * each row (see draw_row_badges()).
  */
 static void draw_crystals(void)
 {
-	int crystal_x;
-	int crystal_y;
-	int stick_idx;
+	Rectangle vis;
+	int row0, row1;
 
-	stick_idx = 0;
-	crystal_x = CRYSTAL_X;
-	crystal_y = CRYSTAL_Y;
+	vis = board_view_visible(&board);
+	visible_rows(&vis, &row0, &row1);
+	crystal_count = 0;
 
-	if (state != S_PIECE_SHIFTING)
+	for (int i = row0; i < row1; i++)
 	{
-		for (int i = 0; i < MAX_ROWS; i++)
+		/* Collapsed row. */
+		if (board_view_badges(&board))
 		{
-			for (int j = 0; j < sticks[i]; j++)
-			{
-				/* Draw. */
-				if (state != S_REMOVING_PIECE || crystal_row != i || j > crystal_col)
-					DrawTexture(crystal, crystal_x, crystal_y, WHITE);
-				else
-					DrawTexture(crystal, crystal_x, crystal_y, ColorAlpha(WHITE,
-						alpha));
-
-				/* Configure rectangle to track the click. */
-				if (recalculate_crystal_clicks)
-				{
-					crystal_click[stick_idx].row = i;
-					crystal_click[stick_idx].col = j;
-					crystal_click[stick_idx].rect.x = crystal_x;
-					crystal_click[stick_idx].rect.y = crystal_y;
-					crystal_click[stick_idx].rect.width = CRYSTAL_WIDTH;
-					crystal_click[stick_idx].rect.height = CRYSTAL_HEIGHT;
-					stick_idx++;
-				}
-
-				/* Increase X axis. */
-				crystal_x = (crystal_x + CRYSTAL_WIDTH);
-			}
-			crystal_y += CRYSTAL_HEIGHT;
-			crystal_x  = CRYSTAL_X;
+			if (sticks[i])
+				draw_crystal(i, 0, CRYSTAL_X);
 		}
+
+		/* Left-shifting effect. */
+		else if (state == S_PIECE_SHIFTING && i == crystal_row)
+			draw_row(&vis, i, crystal_col + 1, (int)sticks[i],
+				(int)tween_value(&shift));
+
+		else
+			draw_row(&vis, i, 0, (int)sticks[i], CRYSTAL_X);
 	}
 
-	/* Left-shifting effect. */
-	else
+	if (instanced)
 	{
-		for (int i = 0; i < MAX_ROWS; i++)
-		{
-			int j = 0;
-			if (i == crystal_row)
-			{
-				j = crystal_col + 1;
-				crystal_x = move_start_x;
-			}
+		flush_sprites();
+		draw_instances(&crystal_instances, crystal_count);
+	}
+}
 
-			for (; j < sticks[i]; j++)
-			{
-				/* Draw. */
-				DrawTexture(crystal, crystal_x, crystal_y, WHITE);
+/**
+ * Draw the crystal count of the visible rows (screen coordinates),
+ * when zoomed out; rows too thin for a badge each are skipped.
+ */
+static void draw_row_badges(void)
+{
+	Rectangle vis;
+	Vector2 pos;
+	int row0, row1;
+	int step;
+	int i;
 
-				/* Increase X axis. */
-				crystal_x += CRYSTAL_WIDTH;
-			}
-			crystal_y += CRYSTAL_HEIGHT;
-			crystal_x  = CRYSTAL_X;
-		}
+	if (!board_view_badges(&board))
+		return;
+
+	vis = board_view_visible(&board);
+	visible_rows(&vis, &row0, &row1);
+
+	step = (int)ceilf((BADGE_SIZE + 2) / (CRYSTAL_HEIGHT * board.camera.zoom));
+	for (i = row0 - row0 % step; i < row1; i += step)
+	{
+		if (i < row0 || !sticks[i])
+			continue;
+
+		pos.x = CRYSTAL_X + CRYSTAL_WIDTH;
+		pos.y = CRYSTAL_Y + i*CRYSTAL_HEIGHT + (CRYSTAL_HEIGHT >> 1);
+		pos   = GetWorldToScreen2D(pos, board.camera);
+
+		DrawRectangle((int)pos.x + 2, (int)pos.y - (BADGE_SIZE >> 1) - 1,
+			measure_text(TextFormat("%d", (int)sticks[i]), BADGE_SIZE) + 4,
+			BADGE_SIZE + 2, ColorAlpha(BLACK, 0.6f));
+		draw_text(TextFormat("%d", (int)sticks[i]), (int)pos.x + 4,
+			(int)pos.y - (BADGE_SIZE >> 1), BADGE_SIZE, WHITE);
 	}
 }
 
@@ -344,15 +529,12 @@ static void draw_crystals(void)
 static void draw_crystal_selection(void)
 {
 	/* If there is a click, draw the selection. */
-	if (turn == PLAYER_TURN && (crystal_idx != -1 || crystal_row > -1))
+	if (turn == PLAYER_TURN && hover_row != -1)
 	{
-		int posX = crystal_click[crystal_idx -
-						crystal_click[crystal_idx].col].rect.x;
-		int posY = crystal_click[crystal_idx -
-						crystal_click[crystal_idx].col].rect.y;
+		int posX = CRYSTAL_X;
+		int posY = CRYSTAL_Y + hover_row*CRYSTAL_HEIGHT;
 
-		int width  = crystal_click[crystal_idx].rect.x + CRYSTAL_WIDTH -
-			posX + 1;
+		int width  = (hover_col + 1)*CRYSTAL_WIDTH + 1;
 		int height = CRYSTAL_HEIGHT;
 
 		if (crystal_row == -1)
@@ -364,20 +546,19 @@ static void draw_crystal_selection(void)
 		else if (state == S_REMOVING_PIECE)
 			DrawRectangleRoundedLines(((Rectangle){.x=posX, .y=posY,
 				.width=width, .height=height}), 0.2f, 0, 3,
-				ColorAlpha(DARKGREEN, alpha));
+				ColorAlpha(DARKGREEN, tween_value(&fade)));
 	}
 }
 
 /**
  * Main game logic is here:
  * - Check for mouse clicks on the sticks
- * - Manage the states and alpha channels
- * - Manage crystals movement while removing them
+ * - Manage the states
  * - Manage crystals selection
  */
 static void logic_think(void)
 {
-	int i;
+	Vector2 world;
 
 	if (turn == PLAYER_TURN)
 	{
@@ -386,37 +567,38 @@ static void logic_think(void)
 			/* Only check if there is no crystal selected. */
 			if (crystal_row == -1)
 			{
+				hover_row = -1;
+				hover_col = -1;
+
 				/* Check for clicks in the sticks/crystals. */
-				for (i = 0; i < sticks_count; i++)
+				if (board_view_pointer(&board, mouse, &world) &&
+					!board_view_badges(&board))
 				{
-					if (CheckCollisionPointRec(mouse, crystal_click[i].rect))
-					{
-						crystal_idx = i;
-						break;
-					}
+					crystal_at(world, &hover_row, &hover_col);
 				}
 
-				/* Reset selection if mouse is not over them anymore. */
-				if (i == sticks_count)
-					crystal_idx = -1;
-
 				/* If there is a mouse click and a valid crystal selection. */
-				if (IsClick() && crystal_idx > -1)
+				if (IsClick() && hover_row > -1)
 				{
-					crystal_row = crystal_click[crystal_idx].row;
-					crystal_col = crystal_click[crystal_idx].col;
+					crystal_row = hover_row;
+					crystal_col = hover_col;
 				}
 			}
 		}
 	}
 
-	/* If Computer turn and default state. */
+	/* If Computer turn and default state, start thinking. */
 	else if (state == S_DEFAULT)
 	{
-		computer_think();
-		alpha = 1.0f;
-		state = S_CONFIRM_REMOVE;
-		frame_counter = 0;
+		computer_start_thinking();
+		state = S_AI_THINKING;
+	}
+
+	/* Wait for the computer to choose. */
+	else if (state == S_AI_THINKING)
+	{
+		if (computer_done_thinking())
+			state = S_CONFIRM_REMOVE;
 	}
 
 	/* Define rectangles for accept/deny buttons. */
@@ -429,9 +611,9 @@ static void logic_think(void)
 			if (CheckCollisionPointRec(mouse, accept_rect))
 			{
 				/* Confirmed sticks deletion. */
-				alpha = 1.0f;
+				tween_start(&fade, 1.0f, 0.0f, REMOVE_TIME, EASE_LINEAR,
+					TWEEN_ONCE);
 				state = S_REMOVING_PIECE;
-				frame_counter = 0;
 			}
 		
 			else if (CheckCollisionPointRec(mouse, deny_rect))
@@ -439,67 +621,85 @@ static void logic_think(void)
 				if (IsClick())
 				{
 					/* Reset selection. */
-					crystal_idx = -1;
+					hover_row   = -1;
+					hover_col   = -1;
 					crystal_row = -1;
 					crystal_col = -1;
 				}
 			}
 		}
 	}
+}
+
+/**
+ * Advance the animations by @p dt seconds, and switch the states
+ * when they finish:
+ * - Removed crystals fade out, then the remaining ones of the row
+ *   shift to the left, then the crystals are actually removed.
+ * - At the end of the game the result fades in, then the 'play
+ *   again' text blinks.
+ */
+static void animate(float dt)
+{
+	int full_row;
 
-	/* Common between turns. */
-	if (state == S_REMOVING_PIECE)
+	switch (state)
 	{
-		frame_counter++;
-		if (frame_counter < (FPS))
-			alpha -= 1.0f/(float)(FPS);
-		else
+		case S_REMOVING_PIECE:
 		{
+			tween_update(&fade, dt);
+			if (!fade.done)
+				break;
+
 			state = S_PIECE_SHIFTING;
-			alpha = 1.0f;
 
 			/* If removing entire row, do not waste time shifting. */
-			if (sticks[crystal_row] != crystal_col + 1)
-				frame_counter = 0;
-			else
-				frame_counter = FPS;
-
-			/* Set our variables. */
-			move_start_x = CRYSTAL_X + ((crystal_col+1)*CRYSTAL_WIDTH);
-			move_step    = ((crystal_col+1)*CRYSTAL_WIDTH)/FPS;
+			full_row = ((int)sticks[crystal_row] == crystal_col + 1);
+			tween_start(&shift, CRYSTAL_X + ((crystal_col+1)*CRYSTAL_WIDTH),
+				CRYSTAL_X, full_row ? 0.0f : SHIFT_TIME, EASE_IN_OUT_QUAD,
+				TWEEN_ONCE);
+			break;
 		}
-	}
 
-	else if (state == S_PIECE_SHIFTING)
-	{
-		frame_counter++;
-		if (frame_counter <= FPS)
-			move_start_x -= move_step;
-		else
+		case S_PIECE_SHIFTING:
 		{
+			tween_update(&shift, dt);
+			if (!shift.done)
+				break;
+
 			/*
 			 * Remove properly the pieces.
 			 */
 			sticks[crystal_row] -= crystal_col + 1;
 			sticks_count -= crystal_col + 1;
-			recalculate_crystal_clicks = 1;
 
 			/* Reset selection and state. */
 			state = S_DEFAULT;
-			crystal_idx = -1;
+			hover_row = -1;
+			hover_col = -1;
 			crystal_row = -1;
 			crystal_col = -1;
 
 			/* Invert turn. */
 			turn = !turn;
+			break;
+		}
 
-			/* Reset alpha if game is over. */
-			if (!sticks_count)
-			{
-				alpha = 0.0f;
-				alpha_inc = 1.0f/(float)FPS*2;
-			}
+		case S_FADE_END:
+		{
+			tween_update(&fade, dt);
+			if (!fade.done)
+				break;
+
+			state = S_FADE_PLAY_AGAIN;
+			tween_start(&fade_again, 0.0f, 1.0f, FADE_TIME, EASE_LINEAR,
+				TWEEN_PING_PONG);
+			break;
 		}
+
+		case S_FADE_PLAY_AGAIN:
+			tween_update(&fade_again, dt);
+			break;
 	}
 }
 
@@ -515,47 +715,177 @@ void setup_crystals_amount(void)
 {
 	int i;
 
+	sticks_count = 0;
+
 	/* Random selected. */
 	if (cb_rnd_amt_selected)
 	{
-		sticks_count = 0;
-		for (i = 0; i < MAX_ROWS; i++)
+		nim_rand_boards(&game_rand, sticks, 1, sticks_rows, 1,
+			sticks_per_row);
+		for (i = 0; i < sticks_rows; i++)
+			sticks_count += sticks[i];
+	}
+
+	/* Default config: 1, 3, 5, 7... up to sticks_per_row. */
+	else
+	{
+		for (i = 0; i < sticks_rows; i++)
 		{
-			sticks[i] = GetRandomValue(1, 7);
+			sticks[i] = (i << 1) + 1;
+			if (sticks[i] > (uint64_t)sticks_per_row)
+				sticks[i] = sticks_per_row;
 			sticks_count += sticks[i];
 		}
 	}
+}
 
-	/* Default config. */
-	else
+/**
+ * Returns the size, in bytes, of the crystal instances buffer: the
+ * same in memory and in the GPU.
+ */
+static size_t instances_size(void)
+{
+	return (crystal_instances.max * sizeof(*crystal_instances.data));
+}
+
+/**
+ * Load the board: crystals amount per row, board view and the
+ * crystal instances.
+ */
+int load_ingame_board(void)
+{
+	sticks = calloc(sticks_rows, sizeof(*sticks));
+	if (!sticks)
+		return (-1);
+	mem_alloc(MEM_GAME, SCENE_INGAME, sticks_rows * sizeof(*sticks));
+
+	init_board_view(&board,
+		(Rectangle){.x = BOARD_X, .y = BOARD_Y,
+			.width = BOARD_WIDTH, .height = BOARD_HEIGHT},
+		(Rectangle){.x = CRYSTAL_X, .y = CRYSTAL_Y,
+			.width  = (float)sticks_per_row * CRYSTAL_WIDTH,
+			.height = (float)sticks_rows * CRYSTAL_HEIGHT});
+
+	/* Room for the visible crystals, at most. */
+	instanced = !init_instances(&crystal_instances, SPRITE_CRYSTAL,
+		max_visible_crystals(INSTANCED_BADGE_ZOOM));
+	if (instanced)
 	{
-		sticks_count  = DEFAULT_STICKS;
-		sticks[0]     = 1;
-		sticks[1]     = 3;
-		sticks[2]     = 5;
-		sticks[3]     = 7;
+		board.badge_zoom = INSTANCED_BADGE_ZOOM;
+		mem_alloc(MEM_GAME, SCENE_INGAME, instances_size());
+		mem_alloc(MEM_GAME|MEM_GPU, SCENE_INGAME, instances_size());
 	}
+
+	return (0);
 }
 
 /**
- * Load in-game resources.
+ * Free the board.
  */
-void init_ingame(void)
+void unload_ingame_board(void)
 {
-	Vector2 pa_vec;
+	if (instanced)
+	{
+		mem_free(MEM_GAME, SCENE_INGAME, instances_size());
+		mem_free(MEM_GAME|MEM_GPU, SCENE_INGAME, instances_size());
+	}
+	mem_free(MEM_GAME, SCENE_INGAME, sticks_rows * sizeof(*sticks));
+
+	finish_instances(&crystal_instances);
+	instanced = false;
+	free(sticks);
+	sticks = NULL;
+}
+
+/**
+ * Load the computer: AI worker and MCTS arena.
+ *
+ * The MCTS generator is seeded from the game generator on the first
+ * load only, and kept across reloads, so that seeded games replay
+ * the same regardless of when the arena was released.
+ */
+int load_ingame_ai(void)
+{
+	if (nim_ai_init(&ai) < 0)
+		return (-1);
+
+	if (!mcts_seeded)
+	{
+		nim_rand_seed(&mcts_rng, nim_rand_next(&game_rand));
+		mcts_seeded = true;
+	}
+
+	if (nim_mcts_init(&mcts, 0, 0) < 0)
+	{
+		nim_ai_finish(&ai);
+		return (-1);
+	}
+	mcts.rng      = mcts_rng;
+	mcts.stop     = computer_cancelled;
+	mcts.stop_arg = &ai;
+
+	mcts_bytes = nim_mcts_memory(&mcts);
+	mem_alloc(MEM_ENGINE, SCENE_INGAME, mcts_bytes);
+	return (0);
+}
+
+/**
+ * Free the computer, keeping the MCTS generator state.
+ */
+void unload_ingame_ai(void)
+{
+	nim_ai_finish(&ai);
+	mcts_rng = mcts.rng;
+	nim_mcts_free(&mcts);
+	mem_free(MEM_ENGINE, SCENE_INGAME, mcts_bytes);
+}
 
-	crystal = LoadTexture("resources/crystal.png");
-	accept  = LoadTexture("resources/accept.png");
-	deny    = LoadTexture("resources/deny.png");
+/**
+ * Load the tablebase, only if present and matching the game rules:
+ * never fails.
+ */
+int load_ingame_tablebase(void)
+{
+	if (!nim_tb_open(&tablebase, TABLEBASE_FILE))
+	{
+		if (tablebase.variant.take_mask || !tablebase.variant.misere)
+		{
+			TraceLog(LOG_WARNING, "Ignoring tablebase %s: variant mismatch",
+				TABLEBASE_FILE);
+			nim_tb_close(&tablebase);
+		}
+	}
 
-	assert(accept.width   == CB_ACCEPT_WIDTH);
-	assert(accept.height  == CB_ACCEPT_HEIGHT);
-	assert(deny.width     == CB_DENY_WIDTH);
-	assert(deny.height    == CB_DENY_HEIGHT);
-	assert(crystal.width  == CRYSTAL_WIDTH);
-	assert(crystal.height == CRYSTAL_HEIGHT);
+	mem_alloc(MEM_ENGINE, SCENE_INGAME, nim_tb_memory(&tablebase));
+	mem_alloc(MEM_ENGINE|MEM_MAPPED, SCENE_INGAME, tablebase.map_size);
+	return (0);
+}
+
+/**
+ * Unmap the tablebase.
+ */
+void unload_ingame_tablebase(void)
+{
+	mem_free(MEM_ENGINE, SCENE_INGAME, nim_tb_memory(&tablebase));
+	mem_free(MEM_ENGINE|MEM_MAPPED, SCENE_INGAME, tablebase.map_size);
+	nim_tb_close(&tablebase);
+}
+
+/**
+ * Enter the game: the board, computer and tablebase are already
+ * loaded, see scene_mgr.h.
+ */
+void enter_ingame(void)
+{
+	Vector2 pa_vec;
+
+	assert(sprite_rect(SPRITE_ACCEPT).width   == CB_ACCEPT_WIDTH);
+	assert(sprite_rect(SPRITE_ACCEPT).height  == CB_ACCEPT_HEIGHT);
+	assert(sprite_rect(SPRITE_DENY).width     == CB_DENY_WIDTH);
+	assert(sprite_rect(SPRITE_DENY).height    == CB_DENY_HEIGHT);
+	assert(sprite_rect(SPRITE_CRYSTAL).width  == CRYSTAL_WIDTH);
+	assert(sprite_rect(SPRITE_CRYSTAL).height == CRYSTAL_HEIGHT);
 
-	/* Too earlier to do that, but saves some processing later. */
 	accept_rect.x = CB_START_X + ((SB_WIDTH - ((CB_ACCEPT_WIDTH << 1) +
 		CB_SPACING)) >> 1);
 	accept_rect.y = CB_START_Y;
@@ -569,21 +899,28 @@ void init_ingame(void)
 
 	pa_vec = MeasureTextEx(GetFontDefault(), TXT_PA, (float)PA_SIZE,
 		(float)PA_SIZE/10);
-	play_again_rect.x = ((SCREEN_WIDTH >> 1) - (MeasureText(TXT_PA,
+	play_again_rect.x = ((SCREEN_WIDTH >> 1) - (measure_text(TXT_PA,
 		PA_SIZE) >> 1));
 	play_again_rect.y = PA_Y;
 	play_again_rect.width = pa_vec.x;
 	play_again_rect.height = pa_vec.y;
+
+	/* Initialize sticks amount. */
+	setup_crystals_amount();
 }
 
 /**
- * Free in-game resources.
+ * Leave the game: reset all the game state.
  */
-void finish_ingame(void)
+void exit_ingame(void)
 {
-	UnloadTexture(crystal);
-	UnloadTexture(accept);
-	UnloadTexture(deny);
+	nim_ai_cancel(&ai);
+	hover_row   = -1;
+	hover_col   = -1;
+	crystal_row = -1;
+	crystal_col = -1;
+	state       = S_DEFAULT;
+	board_moving = false;
 }
 
 /**
@@ -592,67 +929,89 @@ void finish_ingame(void)
  */
 void update_ingame_logic(void)
 {
+	int steps;
+
+	steps = tween_clock_steps(&anim_clock, frame_time());
+
+	board_moving = false;
 	if (sticks_count > 0)
 	{
+		board_moving = update_board_view(&board);
 		logic_think();
-		return;
 	}
 
-	switch (state)
+	else if (state == S_FADE_PLAY_AGAIN)
 	{
-		case S_FADE_END:
+		/* Check if mouse click. */
+		if (CheckCollisionPointRec(mouse, play_again_rect))
 		{
-			frame_counter++;
-			alpha += alpha_inc;
-			if (frame_counter >= FPS/2)
+			if (IsClick())
 			{
-				frame_counter = 0;
-				alpha = 1.0f;
-				state = S_FADE_PLAY_AGAIN;
+				change_scene(SCENE_TUTORIAL);
+				return;
 			}
-			break;
 		}
+	}
 
-		case S_FADE_PLAY_AGAIN:
-		{
-			frame_counter++;
-			alpha_again += alpha_inc;
-		
-			if (frame_counter >= FPS/2)
-			{
-				frame_counter = 0;
-				alpha_inc *= -1.0f;
-			}
+	else if (state != S_FADE_END)
+	{
+		state = S_FADE_END;
+		tween_start(&fade, 0.0f, 1.0f, FADE_TIME, EASE_LINEAR, TWEEN_ONCE);
+	}
 
-			/* Check if mouse click. */
-			if (CheckCollisionPointRec(mouse, play_again_rect))
-			{
-				if (IsClick())
-				{
-					/* Reset all the game state. */
-					frame_counter = 0;
-					alpha         = 1.0f;
-					alpha_again   = 0.0f;
-					alpha_inc     = 1.0f/(float)FPS*2;
-					crystal_idx   = -1;
-					crystal_row   = -1;
-					crystal_col   = -1;
-					move_start_x  =  0;
-					move_step     =  0;
-					state         = S_DEFAULT;
-					global_state  = STATE_TUTORIAL;
-					recalculate_crystal_clicks = -1;
-					setup_crystals_amount();
-				}
-			}
-			break;
-		}
+	while (steps--)
+		animate(TWEEN_STEP);
+}
 
-		default:
-			frame_counter = 0;
-			state = S_FADE_END;
-			break;
-	}
+/**
+ * Returns true if the game is animating or waiting for the
+ * computer, i.e: it must not go idle.
+ */
+bool ingame_is_busy(void)
+{
+	/* Result fade and 'play again' blink. */
+	if (sticks_count <= 0)
+		return (true);
+
+	/* Keyboard scrolling, or a drag/zoom in progress. */
+	if (board_moving)
+		return (true);
+
+	/* Computer about to think, or thinking. */
+	if (turn == COMPUTER_TURN && (state == S_DEFAULT || state == S_AI_THINKING))
+		return (true);
+
+	return (state == S_REMOVING_PIECE || state == S_PIECE_SHIFTING);
+}
+
+/**
+ * Mix into @p key everything the in-game layer depends on.
+ */
+uint64_t ingame_layer_key(uint64_t key)
+{
+	int row;
+	int amt;
+
+	if (sticks_count <= 0)
+		return (layer_key(key, 0));
+
+	status_selection(&row, &amt);
+	key = layer_key(key, 1);
+	key = layer_key(key, (uint64_t)turn);
+	key = layer_key(key, (uint64_t)row);
+	key = layer_key(key, (uint64_t)amt);
+	key = layer_key(key, (uint64_t)(state == S_AI_THINKING));
+	return (layer_key(key, (uint64_t)status_has_buttons()));
+}
+
+/**
+ * Draw the static part of the game (cached in the screen layer):
+ * the status bar, while the game is running.
+ */
+void draw_ingame_layer(void)
+{
+	if (sticks_count > 0)
+		draw_status_bar();
 }
 
 /**
@@ -662,26 +1021,28 @@ void update_ingame_drawing(void)
 {
 	if (sticks_count > 0)
 	{
-		draw_crystals();
+		begin_board_view(&board);
+			draw_crystals();
+			flush_sprites();
+			draw_crystal_selection();
+		end_board_view(&board);
 
-		/* Reset recalculate if set. */
-		if (recalculate_crystal_clicks)
-			recalculate_crystal_clicks = 0;
+		draw_row_badges();
 
-		draw_crystal_selection();
-
-		/* Status bar. */
-		draw_status_bar();
+		/* Status bar buttons (the rest is in the layer). */
+		draw_status_buttons();
 		return;
 	}
 
 	if (turn == PLAYER_TURN)
-		DrawText(TXT_YWIN, ((SCREEN_WIDTH >> 1) - (MeasureText(TXT_YWIN,
-			YWL_SIZE) >> 1)), YWL_Y, YWL_SIZE, ColorAlpha(BLACK, alpha));
+		draw_text(TXT_YWIN, ((SCREEN_WIDTH >> 1) - (measure_text(TXT_YWIN,
+			YWL_SIZE) >> 1)), YWL_Y, YWL_SIZE, ColorAlpha(BLACK,
+			tween_value(&fade)));
 	else
-		DrawText(TXT_YLOSE, ((SCREEN_WIDTH >> 1) - (MeasureText(TXT_YLOSE,
-			YWL_SIZE) >> 1)), YWL_Y, YWL_SIZE, ColorAlpha(BLACK, alpha));
+		draw_text(TXT_YLOSE, ((SCREEN_WIDTH >> 1) - (measure_text(TXT_YLOSE,
+			YWL_SIZE) >> 1)), YWL_Y, YWL_SIZE, ColorAlpha(BLACK,
+			tween_value(&fade)));
 
-	DrawText(TXT_PA, play_again_rect.x, PA_Y, PA_SIZE, ColorAlpha(BLACK,
-		alpha_again));
+	draw_text(TXT_PA, play_again_rect.x, PA_Y, PA_SIZE, ColorAlpha(BLACK,
+		state == S_FADE_PLAY_AGAIN ? tween_value(&fade_again) : 0.0f));
 }
@@ -0,0 +1,222 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "rlgl.h"
+#include "raymath.h"
+#include "gpu_stats.h"
+#include "instances.h"
+#include "sprites.h"
+
+#if defined(INSTANCING)
+
+/* Unit quad, two triangles. */
+static const float quad[12] = {
+	0.0f, 0.0f,  0.0f, 1.0f,  1.0f, 1.0f,
+	0.0f, 0.0f,  1.0f, 1.0f,  1.0f, 0.0f
+};
+
+/* Attribute locations. */
+#define LOC_CORNER   0
+#define LOC_INSTANCE 1
+
+static const char vertex_shader[] =
+	"#version 330\n"
+	"layout(location = 0) in vec2 corner;\n"
+	"layout(location = 1) in vec4 instance;\n"  /* x, y, alpha, selected. */
+	"uniform mat4 mvp;\n"
+	"uniform vec4 spriteRect;\n"               /* u0, v0, u1, v1.        */
+	"uniform vec2 spriteSize;\n"
+	"out vec2 fragTexCoord;\n"
+	"out vec4 fragColor;\n"
+	"void main()\n"
+	"{\n"
+	"    fragTexCoord = mix(spriteRect.xy, spriteRect.zw, corner);\n"
+	"    fragColor    = mix(vec4(1.0), vec4(0.690, 0.871, 1.0, 1.0),\n"
+	"        instance.w);\n"
+	"    fragColor.a  = instance.z;\n"
+	"    gl_Position  = mvp*vec4(instance.xy + corner*spriteSize, 0.0, 1.0);\n"
+	"}\n";
+
+static const char fragment_shader[] =
+	"#version 330\n"
+	"in vec2 fragTexCoord;\n"
+	"in vec4 fragColor;\n"
+	"uniform sampler2D texture0;\n"
+	"out vec4 finalColor;\n"
+	"void main()\n"
+	"{\n"
+	"    finalColor = texture(texture0, fragTexCoord)*fragColor;\n"
+	"}\n";
+
+/**
+ * Initialize @p si, drawing up to @p max instances of the atlas
+ * sprite @p sprite.
+ *
+ * Returns 0 if success, -1 otherwise (no instancing: the sprite
+ * batch should be used instead).
+ */
+int init_instances(struct sprite_instances *si, int sprite, int max)
+{
+	memset(si, 0, sizeof(*si));
+
+	si->shader   = LoadShaderFromMemory(vertex_shader, fragment_shader);
+	si->loc_mvp  = GetShaderLocation(si->shader, "mvp");
+	si->loc_rect = GetShaderLocation(si->shader, "spriteRect");
+	si->loc_size = GetShaderLocation(si->shader, "spriteSize");
+
+	/* Build failed: raylib falls back to its default shader. */
+	if (si->loc_rect < 0 || si->loc_size < 0)
+	{
+		TraceLog(LOG_WARNING, "Instancing unavailable, using the sprite batch");
+		UnloadShader(si->shader);
+		return (-1);
+	}
+
+	if (!(si->data = calloc(max, sizeof(*si->data))))
+	{
+		UnloadShader(si->shader);
+		return (-1);
+	}
+
+	si->sprite   = sprite;
+	si->max      = max;
+	si->dirty_lo = max;
+	si->dirty_hi = 0;
+
+	si->vao = rlLoadVertexArray();
+	rlEnableVertexArray(si->vao);
+
+		si->quad_vbo = rlLoadVertexBuffer((void *)quad, sizeof(quad), false);
+		rlSetVertexAttribute(LOC_CORNER, 2, RL_FLOAT, false, 0, 0);
+		rlEnableVertexAttribute(LOC_CORNER);
+
+		si->vbo = rlLoadVertexBuffer(si->data, max * sizeof(*si->data), true);
+		rlSetVertexAttribute(LOC_INSTANCE, 4, RL_FLOAT, false, 0, 0);
+		rlSetVertexAttributeDivisor(LOC_INSTANCE, 1);
+		rlEnableVertexAttribute(LOC_INSTANCE);
+
+	rlDisableVertexArray();
+	return (0);
+}
+
+/**
+ * Release @p si.
+ */
+void finish_instances(struct sprite_instances *si)
+{
+	if (!si->data)
+		return;
+
+	rlUnloadVertexArray(si->vao);
+	rlUnloadVertexBuffer(si->quad_vbo);
+	rlUnloadVertexBuffer(si->vbo);
+	UnloadShader(si->shader);
+	free(si->data);
+	si->data = NULL;
+}
+
+/**
+ * Draw the first @p count instances of @p si, with the current
+ * transformation (e.g: within BeginMode2D()), in a single call.
+ *
+ * Sprites queued before must be flushed by the caller.
+ */
+void draw_instances(struct sprite_instances *si, int count)
+{
+	Texture2D atlas = sprite_atlas();
+	Rectangle r     = sprite_rect(si->sprite);
+	float rect[4];
+	float size[2];
+	Matrix mvp;
+
+	if (count > si->max)
+		count = si->max;
+	if (!count)
+		return;
+
+	/* Upload the changed instances only. */
+	if (si->dirty_lo < si->dirty_hi)
+	{
+		rlUpdateVertexBuffer(si->vbo, &si->data[si->dirty_lo],
+			(si->dirty_hi - si->dirty_lo) * sizeof(*si->data),
+			si->dirty_lo * sizeof(*si->data));
+		si->dirty_lo = si->max;
+		si->dirty_hi = 0;
+	}
+
+	rect[0] = r.x / atlas.width;
+	rect[1] = r.y / atlas.height;
+	rect[2] = (r.x + r.width)  / atlas.width;
+	rect[3] = (r.y + r.height) / atlas.height;
+	size[0] = r.width;
+	size[1] = r.height;
+
+	/* Whatever rlgl has batched goes first. */
+	rlDrawRenderBatchActive();
+
+	mvp = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+
+	rlEnableShader(si->shader.id);
+		rlSetUniformMatrix(si->loc_mvp, mvp);
+		rlSetUniform(si->loc_rect, rect, SHADER_UNIFORM_VEC4, 1);
+		rlSetUniform(si->loc_size, size, SHADER_UNIFORM_VEC2, 1);
+
+		rlActiveTextureSlot(0);
+		rlEnableTexture(atlas.id);
+
+		rlEnableVertexArray(si->vao);
+			rlDrawVertexArrayInstanced(0, 6, count);
+		rlDisableVertexArray();
+
+		rlDisableTexture();
+	rlDisableShader();
+
+	GPU_DIRECT_DRAW(6UL * count);
+}
+
+#else
+
+int init_instances(struct sprite_instances *si, int sprite, int max)
+{
+	((void)sprite);
+	((void)max);
+	memset(si, 0, sizeof(*si));
+	return (-1);
+}
+
+void finish_instances(struct sprite_instances *si)
+{
+	((void)si);
+}
+
+void draw_instances(struct sprite_instances *si, int count)
+{
+	((void)si);
+	((void)count);
+}
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "layers.h"
+#include "mem_stats.h"
+#include "sprites.h"
+
+/* Layer copy blending: GL_ONE, GL_ZERO and GL_FUNC_ADD. */
+#define COPY_SRC_FACTOR 0x0001
+#define COPY_DST_FACTOR 0x0000
+#define COPY_EQUATION   0x8006
+
+/**
+ * Returns the size, in bytes, of the layer @p l: color texture and
+ * depth buffer (24 bits, usually padded to 32).
+ */
+static size_t layer_size(const struct layer *l)
+{
+	return (2 * mem_pixels_size(l->target.texture.width,
+		l->target.texture.height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8));
+}
+
+/**
+ * Initialize the layer @p l, covering the screen area @p rect.
+ */
+void init_layer(struct layer *l, Rectangle rect)
+{
+	l->target   = LoadRenderTexture((int)rect.width, (int)rect.height);
+	l->rect     = rect;
+	l->key      = 0;
+	l->valid    = 0;
+	l->rebuilds = 0;
+
+	if (l->target.id)
+		mem_alloc(MEM_TEXTURES|MEM_GPU, MEM_SHARED, layer_size(l));
+}
+
+/**
+ * Release the layer @p l.
+ */
+void finish_layer(struct layer *l)
+{
+	if (l->target.id)
+		mem_free(MEM_TEXTURES|MEM_GPU, MEM_SHARED, layer_size(l));
+	UnloadRenderTexture(l->target);
+	l->valid = 0;
+}
+
+/**
+ * Force the next draw_layer() of @p l to rebuild it.
+ */
+void invalidate_layer(struct layer *l)
+{
+	l->valid = 0;
+}
+
+/**
+ * Draw the layer @p l; if @p key differs from the one of the last
+ * build, rebuild it first with @p draw, which draws in screen
+ * coordinates.
+ */
+void draw_layer(struct layer *l, uint64_t key, void (*draw)(void))
+{
+	Rectangle src;
+
+	/* Keep the order of whatever was queued before. */
+	flush_sprites();
+
+	if (!l->valid || l->key != key)
+	{
+		BeginTextureMode(l->target);
+			ClearBackground(BLANK);
+			rlPushMatrix();
+				rlTranslatef(-l->rect.x, -l->rect.y, 0.0f);
+				draw();
+				flush_sprites();
+			rlPopMatrix();
+		EndTextureMode();
+
+		l->key   = key;
+		l->valid = 1;
+		l->rebuilds++;
+	}
+
+	/* Render textures are upside down. */
+	src.x      = 0.0f;
+	src.y      = 0.0f;
+	src.width  = l->rect.width;
+	src.height = -l->rect.height;
+
+	/*
+	 * Plain copy: the colors are right, but the alpha of what was
+	 * blended into the texture is not, so it is ignored.
+	 */
+	rlSetBlendFactors(COPY_SRC_FACTOR, COPY_DST_FACTOR, COPY_EQUATION);
+	BeginBlendMode(BLEND_CUSTOM);
+		DrawTextureRec(l->target.texture, src,
+			(Vector2){.x = l->rect.x, .y = l->rect.y}, WHITE);
+	EndBlendMode();
+}
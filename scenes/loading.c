@@ -0,0 +1,57 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "raylib.h"
+#include "scenes.h"
+#include "scene_mgr.h"
+#include "assets.h"
+#include "text_cache.h"
+
+/**
+ * Update game logic: the other scenes only need the atlas, the
+ * remaining assets show up as soon as they are ready.
+ */
+void update_loading_logic(void)
+{
+	if (asset_ready(ASSET_ATLAS))
+		change_scene(SCENE_TUTORIAL);
+}
+
+/**
+ * Update game drawing: loading progress.
+ */
+void update_loading_drawing(void)
+{
+	float done = (float)assets_done() / ASSET_COUNT;
+
+	draw_text("Loading...", LOADING_X, LOADING_Y - FONT_SIZE - 5, FONT_SIZE,
+		BLACK);
+
+	DrawRectangle(LOADING_X, LOADING_Y, LOADING_WIDTH, LOADING_HEIGHT,
+		LIGHTGRAY);
+	DrawRectangle(LOADING_X, LOADING_Y, (int)(LOADING_WIDTH * done),
+		LOADING_HEIGHT, LIGHT_BLUE);
+	DrawRectangleLines(LOADING_X, LOADING_Y, LOADING_WIDTH, LOADING_HEIGHT,
+		BLUE);
+}
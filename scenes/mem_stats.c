@@ -0,0 +1,375 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "scenes.h"
+#include "mem_stats.h"
+
+#if MEM_THREADS
+	#include <pthread.h>
+	static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+	#define LOCK()   pthread_mutex_lock(&mutex)
+	#define UNLOCK() pthread_mutex_unlock(&mutex)
+#else
+	#define LOCK()
+	#define UNLOCK()
+#endif
+
+/**
+ * Counter: current bytes, high-water mark and budget (0: none).
+ */
+struct mem_counter
+{
+	size_t bytes;
+	size_t peak;
+	size_t budget;
+	bool over;
+};
+
+/* Counters. */
+static struct mem_counter categories[MEM_CATEGORIES] = {
+	[MEM_TEXTURES] = {.budget = MEM_BUDGET_TEXTURES},
+	[MEM_FONTS]    = {.budget = MEM_BUDGET_FONTS},
+	[MEM_GAME]     = {.budget = MEM_BUDGET_GAME},
+	[MEM_ENGINE]   = {.budget = MEM_BUDGET_ENGINE},
+};
+static struct mem_counter owners[MEM_OWNERS];
+static struct mem_counter heap = {.budget = MEM_BUDGET_HEAP};
+static struct mem_counter gpu  = {.budget = MEM_BUDGET_GPU};
+static struct mem_counter mapped;
+
+/* Heap high-water mark of each scene, while current. */
+static size_t scene_peak[SCENE_COUNT];
+static int scene = -1;
+
+static const char *const category_names[MEM_CATEGORIES] = {
+	"textures", "fonts", "game", "engine"
+};
+
+static const char *const owner_names[MEM_OWNERS] = {
+	[SCENE_LOADING]  = "loading",
+	[SCENE_TUTORIAL] = "tutorial",
+	[SCENE_INGAME]   = "ingame",
+	[MEM_SHARED]     = "shared",
+};
+
+/* Overlay layout. */
+#define OV_WIDTH  270
+#define OV_HEIGHT 190
+#define OV_X      (SCREEN_WIDTH - OV_WIDTH - 5)
+#define OV_Y      5
+#define OV_SIZE   10
+#define OV_COLUMN 150 /* Scene peak column. */
+
+/**
+ * Add @p bytes to @p c, warning (once) if it goes over budget.
+ */
+static void counter_add(struct mem_counter *c, const char *name,
+	size_t bytes)
+{
+	c->bytes += bytes;
+	if (c->bytes > c->peak)
+		c->peak = c->bytes;
+
+	if (c->budget && c->bytes > c->budget && !c->over)
+	{
+		c->over = true;
+		TraceLog(LOG_WARNING, "Memory: %s over budget: %zu KiB (budget: "
+			"%zu KiB)", name, c->bytes >> 10, c->budget >> 10);
+	}
+}
+
+/**
+ * Subtract @p bytes from @p c.
+ */
+static void counter_sub(struct mem_counter *c, size_t bytes)
+{
+	c->bytes = bytes < c->bytes ? c->bytes - bytes : 0;
+	if (!c->budget || c->bytes <= c->budget)
+		c->over = false;
+}
+
+/* ---------------------------------------------------------------------- */
+/* Public routines.                                                       */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Account @p bytes allocated by @p owner (a scene or MEM_SHARED)
+ * in @p category, or'ed with MEM_GPU or MEM_MAPPED if not in the
+ * heap.
+ */
+void mem_alloc(int category, int owner, size_t bytes)
+{
+	int cat = category & ~(MEM_GPU|MEM_MAPPED);
+
+	LOCK();
+		counter_add(&owners[owner], owner_names[owner], bytes);
+		if (!(category & MEM_MAPPED))
+			counter_add(&categories[cat], category_names[cat], bytes);
+
+		if (category & MEM_MAPPED)
+			counter_add(&mapped, "mapped", bytes);
+		else if (category & MEM_GPU)
+			counter_add(&gpu, "GPU", bytes);
+		else
+		{
+			counter_add(&heap, "heap", bytes);
+			if (scene >= 0 && heap.bytes > scene_peak[scene])
+				scene_peak[scene] = heap.bytes;
+		}
+	UNLOCK();
+}
+
+/**
+ * Account @p bytes released, see mem_alloc().
+ */
+void mem_free(int category, int owner, size_t bytes)
+{
+	LOCK();
+		counter_sub(&owners[owner], bytes);
+
+		if (category & MEM_MAPPED)
+			counter_sub(&mapped, bytes);
+		else
+		{
+			counter_sub(&categories[category & ~MEM_GPU], bytes);
+			counter_sub((category & MEM_GPU) ? &gpu : &heap, bytes);
+		}
+	UNLOCK();
+}
+
+/**
+ * Returns the size, in bytes, of an image or texture of
+ * @p width x @p height, with @p mipmaps levels, in @p format.
+ */
+size_t mem_pixels_size(int width, int height, int mipmaps, int format)
+{
+	size_t size = 0;
+
+	for (; mipmaps > 0; mipmaps--)
+	{
+		size += (size_t)GetPixelDataSize(width, height, format);
+		width  = width  > 1 ? width  >> 1 : 1;
+		height = height > 1 ? height >> 1 : 1;
+	}
+	return (size);
+}
+
+/**
+ * Set the current scene @p s, for the per-scene high-water marks.
+ */
+void mem_set_scene(int s)
+{
+	LOCK();
+		scene = s;
+		if (heap.bytes > scene_peak[s])
+			scene_peak[s] = heap.bytes;
+	UNLOCK();
+}
+
+/**
+ * Set a budget from the option @p arg: '<name>=<MiB>', where the
+ * name is a category, 'heap' or 'gpu' (0 MiB: none).
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+int mem_parse_budget(const char *arg)
+{
+	struct mem_counter *c;
+	const char *eq;
+	size_t len;
+	char *end;
+	long mib;
+	int i;
+
+	eq = strchr(arg, '=');
+	if (!eq)
+		return (-1);
+
+	mib = strtol(eq + 1, &end, 10);
+	if (end == eq + 1 || *end != '\0' || mib < 0)
+		return (-1);
+
+	len = (size_t)(eq - arg);
+	c = NULL;
+	if (len == 4 && !strncmp(arg, "heap", len))
+		c = &heap;
+	else if (len == 3 && !strncmp(arg, "gpu", len))
+		c = &gpu;
+	for (i = 0; i < MEM_CATEGORIES && !c; i++)
+		if (strlen(category_names[i]) == len &&
+			!strncmp(arg, category_names[i], len))
+		{
+			c = &categories[i];
+		}
+
+	if (!c)
+		return (-1);
+
+	LOCK();
+		c->budget = MEM_MIB(mib);
+	UNLOCK();
+	return (0);
+}
+
+/**
+ * Set the heap budget to @p bytes (0: none).
+ */
+void mem_set_heap_budget(size_t bytes)
+{
+	LOCK();
+		heap.budget = bytes;
+	UNLOCK();
+}
+
+/**
+ * Returns true if any budget is exceeded.
+ */
+bool mem_over_budget(void)
+{
+	bool over;
+	int i;
+
+	LOCK();
+		over = heap.over || gpu.over;
+		for (i = 0; i < MEM_CATEGORIES; i++)
+			over = over || categories[i].over;
+	UNLOCK();
+	return (over);
+}
+
+/**
+ * Log all the counters: current, high-water mark and budget, in
+ * KiB.
+ */
+void dump_mem_stats(void)
+{
+	int i;
+
+	LOCK();
+		TraceLog(LOG_INFO, "Memory (KiB): current, peak, budget");
+		TraceLog(LOG_INFO, "  heap      %8zu %8zu %8zu", heap.bytes >> 10,
+			heap.peak >> 10, heap.budget >> 10);
+		TraceLog(LOG_INFO, "  GPU       %8zu %8zu %8zu", gpu.bytes >> 10,
+			gpu.peak >> 10, gpu.budget >> 10);
+		TraceLog(LOG_INFO, "  mapped    %8zu %8zu %8zu", mapped.bytes >> 10,
+			mapped.peak >> 10, mapped.budget >> 10);
+
+		for (i = 0; i < MEM_CATEGORIES; i++)
+			TraceLog(LOG_INFO, "  %-9s %8zu %8zu %8zu", category_names[i],
+				categories[i].bytes >> 10, categories[i].peak >> 10,
+				categories[i].budget >> 10);
+
+		TraceLog(LOG_INFO, "Memory per owner (KiB): current, peak");
+		for (i = 0; i < MEM_OWNERS; i++)
+			TraceLog(LOG_INFO, "  %-9s %8zu %8zu", owner_names[i],
+				owners[i].bytes >> 10, owners[i].peak >> 10);
+
+		TraceLog(LOG_INFO, "Heap peak per scene (KiB)");
+		for (i = 0; i < SCENE_COUNT; i++)
+			TraceLog(LOG_INFO, "  %-9s %8zu", owner_names[i],
+				scene_peak[i] >> 10);
+	UNLOCK();
+}
+
+#if defined(PROFILE)
+/* Overlay. */
+#if defined(ANDROID)
+static bool visible = true;
+#else
+static bool visible = false;
+#endif
+
+/**
+ * Draw the counter @p c, named @p name, at @p y.
+ */
+static void draw_counter(const char *name, const struct mem_counter *c,
+	int y)
+{
+	DrawText(TextFormat("%-9s %7.2f %7.2f %7.2f", name,
+		c->bytes / 1048576.0, c->peak / 1048576.0, c->budget / 1048576.0),
+		OV_X + 5, y, OV_SIZE, c->over ? RED : WHITE);
+}
+
+/**
+ * Draw the overlay: the counters and the per-scene heap peaks,
+ * in MiB.
+ */
+void draw_mem_stats(void)
+{
+	int y;
+	int i;
+
+#if !defined(ANDROID)
+	if (IsKeyPressed(KEY_F5))
+		visible = !visible;
+#endif
+
+#if defined(WEB)
+	/* The main loop never returns on Web: dump on request. */
+	if (IsKeyPressed(KEY_F6))
+		dump_mem_stats();
+#endif
+
+	if (!visible)
+		return;
+
+	DrawRectangle(OV_X, OV_Y, OV_WIDTH, OV_HEIGHT, Fade(BLACK, 0.7f));
+
+	LOCK();
+		y = OV_Y + 5;
+		DrawText("MiB         now    peak  budget", OV_X + 5, y, OV_SIZE,
+			YELLOW);
+		y += OV_SIZE + 2;
+
+		draw_counter("heap", &heap, y);
+		y += OV_SIZE + 2;
+		draw_counter("GPU", &gpu, y);
+		y += OV_SIZE + 2;
+		draw_counter("mapped", &mapped, y);
+		y += OV_SIZE + 2;
+
+		for (i = 0; i < MEM_CATEGORIES; i++, y += OV_SIZE + 2)
+			draw_counter(category_names[i], &categories[i], y);
+
+		/* Owners, and the heap peak while each scene was current. */
+		y += 4;
+		DrawText("owner       now    peak   scene", OV_X + 5, y, OV_SIZE,
+			YELLOW);
+		y += OV_SIZE + 2;
+
+		for (i = 0; i < MEM_OWNERS; i++, y += OV_SIZE + 2)
+		{
+			DrawText(TextFormat("%-9s %7.2f %7.2f", owner_names[i],
+				owners[i].bytes / 1048576.0, owners[i].peak / 1048576.0),
+				OV_X + 5, y, OV_SIZE, WHITE);
+			if (i < SCENE_COUNT)
+				DrawText(TextFormat("%7.2f", scene_peak[i] / 1048576.0),
+					OV_X + 5 + OV_COLUMN, y, OV_SIZE, WHITE);
+		}
+	UNLOCK();
+}
+#endif
@@ -0,0 +1,251 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "scenes.h"
+#include "profiler.h"
+
+/*
+ * Frame record, in milliseconds.
+ */
+struct prof_frame
+{
+	float total;
+	float phase[PROF_PHASES];
+};
+
+/* Ring buffer. */
+static struct prof_frame history[PROF_HISTORY];
+static unsigned long frames;
+
+/* Current frame. */
+static struct prof_frame current;
+static double frame_start;
+static double phase_start[PROF_PHASES];
+
+/* Overlay. */
+#if defined(ANDROID)
+static bool visible = true;
+#else
+static bool visible = false;
+#endif
+
+static const char *const phase_names[PROF_PHASES] = {
+	"logic", "layer", "scene", "present"
+};
+
+/* Overlay layout. */
+#define OV_X        5
+#define OV_Y        (SCREEN_HEIGHT - OV_HEIGHT - 5)
+#define OV_WIDTH    250
+#define OV_HEIGHT   170
+#define OV_SIZE     10
+#define OV_AVG      60   /* Frames averaged for the phases. */
+#define HIST_BINS   40   /* 1 ms per bin, the last one: more. */
+#define HIST_HEIGHT 40
+
+/**
+ * Comparison for qsort().
+ */
+static int cmp_float(const void *a, const void *b)
+{
+	float fa = *(const float *)a;
+	float fb = *(const float *)b;
+	return ((fa > fb) - (fa < fb));
+}
+
+/**
+ * Start profiling.
+ */
+void init_profiler(void)
+{
+	frames = 0;
+}
+
+/**
+ * Dump the recorded frames (oldest first) as CSV.
+ */
+void finish_profiler(void)
+{
+	unsigned long count;
+	unsigned long i;
+	FILE *f;
+	int p;
+
+#if defined(WEB)
+	/* No persistent file system: the console. */
+	f = stdout;
+#else
+	if (!(f = fopen(PROF_CSV_FILE, "w")))
+	{
+		TraceLog(LOG_WARNING, "Unable to write %s", PROF_CSV_FILE);
+		return;
+	}
+#endif
+
+	fprintf(f, "frame,total_ms");
+	for (p = 0; p < PROF_PHASES; p++)
+		fprintf(f, ",%s_ms", phase_names[p]);
+	fprintf(f, "\n");
+
+	count = frames < PROF_HISTORY ? frames : PROF_HISTORY;
+	for (i = frames - count; i < frames; i++)
+	{
+		const struct prof_frame *fr = &history[i % PROF_HISTORY];
+		fprintf(f, "%lu,%.4f", i, fr->total);
+		for (p = 0; p < PROF_PHASES; p++)
+			fprintf(f, ",%.4f", fr->phase[p]);
+		fprintf(f, "\n");
+	}
+
+	if (f != stdout)
+		fclose(f);
+}
+
+/**
+ * Start timing the phase @p phase.
+ */
+void prof_begin(int phase)
+{
+	phase_start[phase] = GetTime();
+}
+
+/**
+ * Stop timing the phase @p phase; a phase can be timed several
+ * times per frame.
+ */
+void prof_end(int phase)
+{
+	current.phase[phase] += (float)((GetTime() - phase_start[phase]) * 1e3);
+}
+
+/**
+ * Start a new frame.
+ */
+void prof_frame_begin(void)
+{
+	memset(&current, 0, sizeof(current));
+	frame_start = GetTime();
+
+#if !defined(ANDROID)
+	if (IsKeyPressed(KEY_F3))
+		visible = !visible;
+#endif
+
+#if defined(WEB)
+	/* The main loop never returns on Web: dump on request. */
+	if (IsKeyPressed(KEY_F4))
+		finish_profiler();
+#endif
+}
+
+/**
+ * Finish the frame, and record it.
+ */
+void prof_frame_end(void)
+{
+	current.total = (float)((GetTime() - frame_start) * 1e3);
+	history[frames % PROF_HISTORY] = current;
+	frames++;
+}
+
+/**
+ * Draw the overlay: per-phase averages, frame-time percentiles
+ * and histogram.
+ */
+void draw_profiler(void)
+{
+	static float sorted[PROF_HISTORY];
+	unsigned bins[HIST_BINS];
+	float avg[PROF_PHASES];
+	unsigned long count;
+	unsigned long navg;
+	unsigned long i;
+	unsigned max_bin;
+	float total;
+	int bin;
+	int p;
+	int y;
+
+	if (!visible || !frames)
+		return;
+
+	count = frames < PROF_HISTORY ? frames : PROF_HISTORY;
+	navg  = count < OV_AVG ? count : OV_AVG;
+
+	/* Phase averages, last OV_AVG frames. */
+	memset(avg, 0, sizeof(avg));
+	total = 0.0f;
+	for (i = frames - navg; i < frames; i++)
+	{
+		for (p = 0; p < PROF_PHASES; p++)
+			avg[p] += history[i % PROF_HISTORY].phase[p];
+		total += history[i % PROF_HISTORY].total;
+	}
+
+	/* Percentiles and histogram, whole history. */
+	memset(bins, 0, sizeof(bins));
+	for (i = 0; i < count; i++)
+	{
+		sorted[i] = history[(frames - count + i) % PROF_HISTORY].total;
+		bin = (int)sorted[i];
+		bins[bin < HIST_BINS ? bin : HIST_BINS - 1]++;
+	}
+	qsort(sorted, count, sizeof(*sorted), cmp_float);
+
+	DrawRectangle(OV_X, OV_Y, OV_WIDTH, OV_HEIGHT, Fade(BLACK, 0.7f));
+
+	y = OV_Y + 5;
+	DrawText(TextFormat("frame: %6.2f ms (%d FPS)", total / navg, GetFPS()),
+		OV_X + 5, y, OV_SIZE, WHITE);
+	y += OV_SIZE + 2;
+
+	for (p = 0; p < PROF_PHASES; p++, y += OV_SIZE + 2)
+		DrawText(TextFormat("  %-8s %6.2f ms", phase_names[p], avg[p] / navg),
+			OV_X + 5, y, OV_SIZE, WHITE);
+
+	DrawText(TextFormat("p50: %.2f  p95: %.2f  p99: %.2f ms",
+		sorted[count / 2], sorted[count * 95 / 100], sorted[count * 99 / 100]),
+		OV_X + 5, y, OV_SIZE, YELLOW);
+	y += OV_SIZE + 6;
+
+	/* Histogram: 1 ms per bar, scaled to the tallest. */
+	for (max_bin = 1, bin = 0; bin < HIST_BINS; bin++)
+		if (bins[bin] > max_bin)
+			max_bin = bins[bin];
+
+	y += HIST_HEIGHT;
+	for (bin = 0; bin < HIST_BINS; bin++)
+	{
+		int h = (int)((bins[bin] * HIST_HEIGHT) / max_bin);
+		DrawRectangle(OV_X + 5 + bin * 6, y - h, 5, h,
+			bin < 17 ? GREEN : (bin < 34 ? YELLOW : RED));
+	}
+	DrawText("0", OV_X + 5, y + 2, OV_SIZE, WHITE);
+	DrawText(TextFormat("%d+ ms", HIST_BINS - 1), OV_X + 5 + (HIST_BINS-6) * 6,
+		y + 2, OV_SIZE, WHITE);
+}
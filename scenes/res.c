@@ -0,0 +1,133 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "res.h"
+
+/* Inflate, from raylib (see CompressData()). */
+#include "external/sinfl.h"
+
+/**
+ * Returns the first entry of the embedded resource @p name from
+ * @p from on, or -1 if none.
+ */
+int find_res(const char *name, int from)
+{
+	int i;
+
+	for (i = from; i < res_count; i++)
+		if (!strcmp(res_entries[i].name, name))
+			return (i);
+
+	return (-1);
+}
+
+/**
+ * Decode the entry @p entry: RES_PIXELS blobs are inflated
+ * straight into the image data (whatever the pixel format, with
+ * all the mipmaps), and RES_FILE ones decoded from memory.
+ */
+Image load_res(int entry)
+{
+	const struct res_entry *res = &res_entries[entry];
+	Image img = {0};
+	const char *ext;
+
+	if (res->type == RES_FILE)
+	{
+		ext = strrchr(res->name, '.');
+		return (LoadImageFromMemory(ext ? ext : "", res->data,
+			(int)res->size));
+	}
+
+	/* Exact size known, no need for DecompressData()'s scratch. */
+	if (!(img.data = malloc(res->raw_size)))
+		return (img);
+
+	if (sinflate(img.data, res->data, (int)res->size) != res->raw_size)
+	{
+		TraceLog(LOG_WARNING, "Resource %s is corrupted", res->name);
+		free(img.data);
+		img.data = NULL;
+		return (img);
+	}
+
+	img.width   = res->width;
+	img.height  = res->height;
+	img.mipmaps = res->mipmaps;
+	img.format  = res->format;
+	return (img);
+}
+
+/**
+ * Upload @p img, decoded from the entry @p entry.
+ *
+ * Returns the texture, or an empty one (id 0) if the GPU does not
+ * support its format.
+ */
+Texture2D upload_res(int entry, Image img)
+{
+	Texture2D tex = {0};
+
+	/* ETC1 is a subset of ETC2: prefer the latter, if available. */
+	if (entry >= 0 && res_entries[entry].format ==
+		PIXELFORMAT_COMPRESSED_ETC1_RGB)
+	{
+		img.format = PIXELFORMAT_COMPRESSED_ETC2_RGB;
+		tex = LoadTextureFromImage(img);
+		img.format = PIXELFORMAT_COMPRESSED_ETC1_RGB;
+	}
+
+	if (!tex.id)
+		tex = LoadTextureFromImage(img);
+
+	if (tex.id && tex.mipmaps > 1)
+		SetTextureFilter(tex, TEXTURE_FILTER_TRILINEAR);
+
+	return (tex);
+}
+
+/**
+ * Load the image @p name (uncompressed, for CPU use), from the
+ * embedded resources. Resources that were not embedded are loaded
+ * from the file system, if possible.
+ */
+Image load_res_image(const char *name)
+{
+	int e;
+
+	for (e = find_res(name, 0); e >= 0; e = find_res(name, e + 1))
+	{
+		if (res_entries[e].type == RES_FILE ||
+			res_entries[e].format < PIXELFORMAT_COMPRESSED_DXT1_RGB)
+		{
+			return (load_res(e));
+		}
+	}
+
+	TraceLog(LOG_WARNING, "Resource %s not embedded, loading file", name);
+	return (LoadImage(name));
+}
@@ -0,0 +1,357 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stddef.h>
+#include "raylib.h"
+#include "scenes.h"
+#include "scene_mgr.h"
+#include "gpu_stats.h"
+#include "layers.h"
+#include "mem_stats.h"
+
+/* Time an unused resource is kept loaded, '-u seconds'. */
+double scene_unload_delay = SCENE_UNLOAD_DELAY;
+
+/**
+ * Scene resource: loaded on the first reference, released some
+ * time after the last one is gone.
+ */
+struct scene_res
+{
+	const char *name;
+	int (*load)(void);
+	void (*unload)(void);
+	int refs;
+	bool loaded;
+	double idle_since;
+};
+
+/**
+ * Scene: hooks (any of them may be NULL) and the resources it
+ * needs, -1 terminated.
+ */
+struct scene
+{
+	const char *name;
+	void (*enter)(void);
+	void (*exit)(void);
+	void (*update_logic)(void);
+	void (*update_drawing)(void);
+	uint64_t (*layer_key)(uint64_t key);
+	void (*draw_layer)(void);
+	bool (*busy)(void);
+	int gpu_scene;
+	int resources[SCENE_RES_COUNT + 1];
+};
+
+static struct scene_res resources[SCENE_RES_COUNT] = {
+	[SCENE_RES_BOARD] = {
+		.name   = "board",
+		.load   = load_ingame_board,
+		.unload = unload_ingame_board
+	},
+	[SCENE_RES_AI] = {
+		.name   = "ai",
+		.load   = load_ingame_ai,
+		.unload = unload_ingame_ai
+	},
+	[SCENE_RES_TABLEBASE] = {
+		.name   = "tablebase",
+		.load   = load_ingame_tablebase,
+		.unload = unload_ingame_tablebase
+	},
+};
+
+static const struct scene scenes[SCENE_COUNT] = {
+	[SCENE_LOADING] = {
+		.name           = "loading",
+		.update_logic   = update_loading_logic,
+		.update_drawing = update_loading_drawing,
+		.gpu_scene      = GPU_SCENE_NONE,
+		.resources      = {-1}
+	},
+	[SCENE_TUTORIAL] = {
+		.name           = "tutorial",
+		.enter          = enter_tutorial,
+		.update_logic   = update_tutorial_logic,
+		.update_drawing = update_tutorial_drawing,
+		.layer_key      = tutorial_layer_key,
+		.draw_layer     = draw_tutorial_layer,
+		.gpu_scene      = GPU_SCENE_TUTORIAL,
+		.resources      = {-1}
+	},
+	[SCENE_INGAME] = {
+		.name           = "ingame",
+		.enter          = enter_ingame,
+		.exit           = exit_ingame,
+		.update_logic   = update_ingame_logic,
+		.update_drawing = update_ingame_drawing,
+		.layer_key      = ingame_layer_key,
+		.draw_layer     = draw_ingame_layer,
+		.busy           = ingame_is_busy,
+		.gpu_scene      = GPU_SCENE_INGAME,
+		.resources      = {SCENE_RES_BOARD, SCENE_RES_AI, SCENE_RES_TABLEBASE,
+			-1}
+	},
+};
+
+/* Current and requested scenes, -1 if none. */
+static int scene = -1;
+static int next_scene = -1;
+
+/**
+ * Take a reference to every resource of scene @p s, loading the
+ * ones not loaded yet.
+ */
+static void acquire_resources(int s)
+{
+	struct scene_res *res;
+	const int *r;
+
+	for (r = scenes[s].resources; *r >= 0; r++)
+	{
+		res = &resources[*r];
+		if (res->refs++ || res->loaded)
+			continue;
+
+		TraceLog(LOG_INFO, "Loading scene resource: %s", res->name);
+		if (res->load() < 0)
+			TraceLog(LOG_FATAL, "Unable to load scene resource: %s",
+				res->name);
+		res->loaded = true;
+	}
+}
+
+/**
+ * Drop the references of scene @p s: the resources that are no
+ * longer used start counting their idle time.
+ */
+static void release_resources(int s)
+{
+	struct scene_res *res;
+	const int *r;
+
+	for (r = scenes[s].resources; *r >= 0; r++)
+	{
+		res = &resources[*r];
+		if (!--res->refs)
+			res->idle_since = GetTime();
+	}
+}
+
+/**
+ * Unload the resource @p res.
+ */
+static void unload_resource(struct scene_res *res)
+{
+	TraceLog(LOG_INFO, "Unloading scene resource: %s", res->name);
+	res->unload();
+	res->loaded = false;
+}
+
+/**
+ * Unload the resources unused for longer than the unload delay, or
+ * all the unused ones, if over the memory budget (see mem_stats.h).
+ */
+static void unload_idle_resources(void)
+{
+	double now = GetTime();
+	bool evict = mem_over_budget();
+	int r;
+
+	for (r = 0; r < SCENE_RES_COUNT; r++)
+	{
+		if (resources[r].loaded && !resources[r].refs && (evict ||
+			now - resources[r].idle_since >= scene_unload_delay))
+		{
+			unload_resource(&resources[r]);
+		}
+	}
+}
+
+/**
+ * Switch to scene @p s: the new scene resources are acquired before
+ * the old ones are released, so the shared ones stay loaded.
+ */
+static void switch_scene(int s)
+{
+	int old = scene;
+
+	mem_set_scene(s);
+	acquire_resources(s);
+
+	if (old >= 0)
+	{
+		if (scenes[old].exit)
+			scenes[old].exit();
+		release_resources(old);
+	}
+
+	scene = s;
+	if (scenes[s].enter)
+		scenes[s].enter();
+}
+
+/* ---------------------------------------------------------------------- */
+/* Public routines.                                                       */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Enter the first scene @p s.
+ */
+void init_scenes(int s)
+{
+	switch_scene(s);
+}
+
+/**
+ * Exit the current scene and unload all the resources.
+ */
+void finish_scenes(void)
+{
+	int r;
+
+	if (scene >= 0)
+	{
+		if (scenes[scene].exit)
+			scenes[scene].exit();
+		release_resources(scene);
+		scene = -1;
+	}
+
+	for (r = 0; r < SCENE_RES_COUNT; r++)
+		if (resources[r].loaded)
+			unload_resource(&resources[r]);
+}
+
+/**
+ * Request a change to scene @p s, applied at the start of the next
+ * update_scene_logic().
+ */
+void change_scene(int s)
+{
+	next_scene = s;
+}
+
+/**
+ * Returns the current scene, or the requested one, if any.
+ */
+int current_scene(void)
+{
+	return (next_scene >= 0 ? next_scene : scene);
+}
+
+/**
+ * Returns the scene in effect, i.e: the one drawn on this frame,
+ * regardless of any requested change.
+ */
+int active_scene(void)
+{
+	return (scene);
+}
+
+/**
+ * Apply the pending scene change, release the idle resources and
+ * update the current scene logic.
+ */
+void update_scene_logic(void)
+{
+	if (next_scene >= 0)
+	{
+		switch_scene(next_scene);
+		next_scene = -1;
+	}
+
+	unload_idle_resources();
+	scenes[scene].update_logic();
+}
+
+/**
+ * Update the current scene drawing.
+ */
+void update_scene_drawing(void)
+{
+	scenes[scene].update_drawing();
+}
+
+/**
+ * Mix into @p key the current scene and everything its layer
+ * depends on.
+ */
+uint64_t scene_layer_key(uint64_t key)
+{
+	key = layer_key(key, (uint64_t)scene);
+	if (scenes[scene].layer_key)
+		key = scenes[scene].layer_key(key);
+	return (key);
+}
+
+/**
+ * Draw the static part of the current scene, if any.
+ */
+void draw_scene_layer(void)
+{
+	if (scenes[scene].draw_layer)
+		scenes[scene].draw_layer();
+}
+
+/**
+ * Returns true if the current scene must not go idle.
+ */
+bool scene_is_busy(void)
+{
+	return (next_scene >= 0 || (scenes[scene].busy && scenes[scene].busy()));
+}
+
+/**
+ * Returns the time, in seconds, until the next unused resource is
+ * due to be unloaded, or a negative value if none.
+ */
+double scene_unload_timeout(void)
+{
+	double next = -1.0;
+	double due;
+	int r;
+
+	for (r = 0; r < SCENE_RES_COUNT; r++)
+	{
+		if (!resources[r].loaded || resources[r].refs)
+			continue;
+
+		due = resources[r].idle_since + scene_unload_delay - GetTime();
+		if (due < 0.001)
+			due = 0.001;
+		if (next < 0.0 || due < next)
+			next = due;
+	}
+	return (next);
+}
+
+/**
+ * Returns the current scene GPU statistics scene, see gpu_stats.h.
+ */
+int scene_gpu_scene(void)
+{
+	return (scenes[scene].gpu_scene);
+}
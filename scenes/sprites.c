@@ -0,0 +1,132 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "assets.h"
+#include "sprites.h"
+
+/* Atlas (streamed, see assets.h). */
+static const int atlas_rects[SPRITE_COUNT][4] = { ATLAS_RECTS };
+
+/*
+ * Queued sprite.
+ */
+static struct queued_sprite
+{
+	int sprite;
+	int x;
+	int y;
+	Color tint;
+} queue[SPRITE_QUEUE_MAX];
+static int queued;
+
+/**
+ * Returns the rectangle (within the atlas) of @p sprite; the
+ * width and height are the sprite size.
+ */
+Rectangle sprite_rect(int sprite)
+{
+	Rectangle r;
+	r.x      = (float)atlas_rects[sprite][0];
+	r.y      = (float)atlas_rects[sprite][1];
+	r.width  = (float)atlas_rects[sprite][2];
+	r.height = (float)atlas_rects[sprite][3];
+	return (r);
+}
+
+/**
+ * Returns the atlas texture.
+ */
+Texture2D sprite_atlas(void)
+{
+	return (asset_texture(ASSET_ATLAS));
+}
+
+/**
+ * Queue the sprite @p sprite to be drawn at (@p x, @p y), with
+ * the tint @p tint.
+ */
+void draw_sprite(int sprite, int x, int y, Color tint)
+{
+	if (queued == SPRITE_QUEUE_MAX)
+		flush_sprites();
+
+	queue[queued].sprite = sprite;
+	queue[queued].x      = x;
+	queue[queued].y      = y;
+	queue[queued].tint   = tint;
+	queued++;
+}
+
+/**
+ * Draw all the queued sprites, as textured quads from the atlas.
+ *
+ * rlgl merges consecutive quads with the same texture into the
+ * same draw call, so the whole queue goes in a single one (unless
+ * the rlgl batch buffer gets full).
+ */
+void flush_sprites(void)
+{
+	const int *r;
+	float u0, v0;
+	float u1, v1;
+	float x, y;
+	unsigned atlas;
+	int i;
+
+	atlas = asset_texture(ASSET_ATLAS).id;
+	for (i = 0; i < queued; i++)
+	{
+		r  = atlas_rects[queue[i].sprite];
+		x  = (float)queue[i].x;
+		y  = (float)queue[i].y;
+		u0 = (float)r[0] / ATLAS_WIDTH;
+		v0 = (float)r[1] / ATLAS_HEIGHT;
+		u1 = (float)(r[0] + r[2]) / ATLAS_WIDTH;
+		v1 = (float)(r[1] + r[3]) / ATLAS_HEIGHT;
+
+		rlCheckRenderBatchLimit(4);
+		rlSetTexture(atlas);
+		rlBegin(RL_QUADS);
+
+			rlColor4ub(queue[i].tint.r, queue[i].tint.g, queue[i].tint.b,
+				queue[i].tint.a);
+			rlNormal3f(0.0f, 0.0f, 1.0f);
+
+			rlTexCoord2f(u0, v0);
+			rlVertex2f(x, y);
+			rlTexCoord2f(u0, v1);
+			rlVertex2f(x, y + r[3]);
+			rlTexCoord2f(u1, v1);
+			rlVertex2f(x + r[2], y + r[3]);
+			rlTexCoord2f(u1, v0);
+			rlVertex2f(x + r[2], y);
+
+		rlEnd();
+	}
+
+	rlSetTexture(0);
+	queued = 0;
+}
@@ -0,0 +1,561 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "rlgl.h"
+#include "mem_stats.h"
+#include "text_cache.h"
+
+/* Default font size, see DrawText(). */
+#define DEFAULT_FONT_SIZE 10
+
+/*
+ * Glyph quad: screen offset and size (from the text position) and
+ * texture coordinates, valid for both the default and SDF fonts.
+ */
+struct glyph_quad
+{
+	float x, y;
+	float w, h;
+	float u0, v0;
+	float u1, v1;
+};
+
+/*
+ * Laid out text.
+ */
+static struct text_run
+{
+	uint64_t key;         /* 0: empty slot. */
+	char text[TEXT_MAX_LEN];
+	int size;
+	int width;
+	struct glyph_quad *quads;
+	int count;
+	int cap;
+} cache[TEXT_CACHE_SLOTS];
+
+/* SDF font. */
+static Texture2D sdf_texture;
+static Shader sdf_shader;
+static bool sdf_ready;
+
+#if defined(ANDROID) || defined(WEB)
+static const char sdf_fragment_shader[] =
+	"#version 100\n"
+	"#extension GL_OES_standard_derivatives : enable\n"
+	"precision mediump float;\n"
+	"varying vec2 fragTexCoord;\n"
+	"varying vec4 fragColor;\n"
+	"uniform sampler2D texture0;\n"
+	"uniform float smoothing;\n"
+	"void main()\n"
+	"{\n"
+	"    float d = texture2D(texture0, fragTexCoord).a - 0.5;\n"
+	"    float w = smoothing*length(vec2(dFdx(d), dFdy(d)));\n"
+	"    gl_FragColor = vec4(fragColor.rgb,\n"
+	"        fragColor.a*smoothstep(-w, w, d));\n"
+	"}\n";
+#else
+static const char sdf_fragment_shader[] =
+	"#version 330\n"
+	"in vec2 fragTexCoord;\n"
+	"in vec4 fragColor;\n"
+	"uniform sampler2D texture0;\n"
+	"uniform float smoothing;\n"
+	"out vec4 finalColor;\n"
+	"void main()\n"
+	"{\n"
+	"    float d = texture(texture0, fragTexCoord).a - 0.5;\n"
+	"    float w = smoothing*length(vec2(dFdx(d), dFdy(d)));\n"
+	"    finalColor = vec4(fragColor.rgb, fragColor.a*smoothstep(-w, w, d));\n"
+	"}\n";
+#endif
+
+/* ------------------------------------------------------------------------- */
+/* SDF font                                                                  */
+/* ------------------------------------------------------------------------- */
+
+/* 'Infinite' squared distance. */
+#define EDT_INF 1e20
+
+/* Intersection of the parabolas rooted at p and q. */
+#define EDT_MEET(f, q, p) \
+	(((f)[q] + (double)(q)*(q) - ((f)[p] + (double)(p)*(p))) / \
+		(2.0*(q) - 2.0*(p)))
+
+/**
+ * 1D squared Euclidean distance transform of @p f (size @p n)
+ * into @p d (Felzenszwalb & Huttenlocher); @p v and @p z are
+ * scratch buffers of n and n + 1 elements.
+ */
+static void edt_1d(const double *f, double *d, int *v, double *z, int n)
+{
+	double s;
+	int k;
+	int q;
+
+	k    = 0;
+	v[0] = 0;
+	z[0] = -EDT_INF;
+	z[1] =  EDT_INF;
+
+	for (q = 1; q < n; q++)
+	{
+		s = EDT_MEET(f, q, v[k]);
+		while (s <= z[k])
+		{
+			k--;
+			s = EDT_MEET(f, q, v[k]);
+		}
+
+		k++;
+		v[k]     = q;
+		z[k]     = s;
+		z[k + 1] = EDT_INF;
+	}
+
+	for (k = 0, q = 0; q < n; q++)
+	{
+		while (z[k + 1] < q)
+			k++;
+		d[q] = (double)(q - v[k])*(q - v[k]) + f[v[k]];
+	}
+}
+
+/**
+ * 2D squared Euclidean distance transform, in place, of the
+ * @p w x @p h grid @p g: 0 for the feature pixels, EDT_INF for
+ * the others.
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+static int edt_2d(double *g, int w, int h)
+{
+	int n = w > h ? w : h;
+	double *f, *d, *z;
+	int *v;
+	int x, y;
+	int ret;
+
+	f = malloc(n * sizeof(*f));
+	d = malloc(n * sizeof(*d));
+	z = malloc((n + 1) * sizeof(*z));
+	v = malloc(n * sizeof(*v));
+
+	ret = -1;
+	if (!f || !d || !z || !v)
+		goto out;
+
+	for (x = 0; x < w; x++)
+	{
+		for (y = 0; y < h; y++)
+			f[y] = g[y*w + x];
+		edt_1d(f, d, v, z, h);
+		for (y = 0; y < h; y++)
+			g[y*w + x] = d[y];
+	}
+
+	for (y = 0; y < h; y++)
+	{
+		edt_1d(&g[y*w], d, v, z, w);
+		memcpy(&g[y*w], d, w * sizeof(*d));
+	}
+
+	ret = 0;
+out:
+	free(f);
+	free(d);
+	free(z);
+	free(v);
+	return (ret);
+}
+
+/**
+ * Returns the size, in bytes, of the SDF texture.
+ */
+static size_t sdf_texture_size(void)
+{
+	return (mem_pixels_size(sdf_texture.width, sdf_texture.height, 1,
+		sdf_texture.format));
+}
+
+/**
+ * Build the SDF texture: the default font atlas, upscaled by
+ * TEXT_SDF_SCALE, with the (signed) distance to the glyph edges
+ * in the alpha channel (0.5 at the edge).
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+static int build_sdf_texture(void)
+{
+	Image font, sdf;
+	unsigned char *px;
+	double *in, *out;
+	double dist;
+	size_t scratch;
+	int w, h, i;
+	int x, y;
+	int ret;
+
+	font = GetTextureData(GetFontDefault().texture);
+	if (!font.data)
+		return (-1);
+	ImageFormat(&font, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+	w   = font.width  * TEXT_SDF_SCALE;
+	h   = font.height * TEXT_SDF_SCALE;
+	in  = malloc((size_t)w * h * sizeof(*in));
+	out = malloc((size_t)w * h * sizeof(*out));
+	px  = malloc((size_t)w * h * 4);
+
+	scratch = (size_t)w * h * (2 * sizeof(*in) + 4);
+	mem_alloc(MEM_FONTS, MEM_SHARED, scratch);
+
+	ret = -1;
+	if (!in || !out || !px)
+		goto out;
+
+	/* Distances to the glyph pixels (in) and to the background (out). */
+	for (y = 0; y < h; y++)
+	{
+		for (x = 0; x < w; x++)
+		{
+			i = (y / TEXT_SDF_SCALE)*font.width + x / TEXT_SDF_SCALE;
+			if (((unsigned char *)font.data)[i*4 + 3] > 127)
+				in[y*w + x] = 0.0, out[y*w + x] = EDT_INF;
+			else
+				in[y*w + x] = EDT_INF, out[y*w + x] = 0.0;
+		}
+	}
+
+	if (edt_2d(in, w, h) < 0 || edt_2d(out, w, h) < 0)
+		goto out;
+
+	for (i = 0; i < w*h; i++)
+	{
+		dist = sqrt(in[i]) - sqrt(out[i]);
+		dist = 0.5 - dist / (2.0 * TEXT_SDF_SPREAD);
+		dist = dist < 0.0 ? 0.0 : (dist > 1.0 ? 1.0 : dist);
+
+		px[i*4 + 0] = 255;
+		px[i*4 + 1] = 255;
+		px[i*4 + 2] = 255;
+		px[i*4 + 3] = (unsigned char)(dist * 255.0 + 0.5);
+	}
+
+	sdf.data    = px;
+	sdf.width   = w;
+	sdf.height  = h;
+	sdf.mipmaps = 1;
+	sdf.format  = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+
+	sdf_texture = LoadTextureFromImage(sdf);
+	SetTextureFilter(sdf_texture, TEXTURE_FILTER_BILINEAR);
+	ret = sdf_texture.id ? 0 : -1;
+	if (!ret)
+		mem_alloc(MEM_FONTS|MEM_GPU, MEM_SHARED, sdf_texture_size());
+out:
+	UnloadImage(font);
+	free(in);
+	free(out);
+	free(px);
+	mem_free(MEM_FONTS, MEM_SHARED, scratch);
+	return (ret);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Layout                                                                    */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Cache key of @p text at @p size (FNV-1a), never 0.
+ */
+static uint64_t text_key(const char *text, int size)
+{
+	uint64_t key = 0xCBF29CE484222325ULL ^ (uint64_t)size;
+
+	for (; *text; text++)
+		key = (key ^ (unsigned char)*text) * 0x100000001B3ULL;
+
+	return (key ? key : 1);
+}
+
+/**
+ * Lay out @p text at @p size into @p r, as DrawText() does.
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+static int layout(struct text_run *r, const char *text, int size)
+{
+	Font font = GetFontDefault();
+	struct glyph_quad *q;
+	float scale;
+	float off_x;
+	int off_y;
+	int spacing;
+	int bytes;
+	int cp, idx;
+	int i, len;
+
+	if (size < DEFAULT_FONT_SIZE)
+		size = DEFAULT_FONT_SIZE;
+	spacing = size / DEFAULT_FONT_SIZE;
+	scale   = (float)size / font.baseSize;
+
+	len      = (int)strlen(text);
+	r->count = 0;
+
+	if (len > r->cap)
+	{
+		q = realloc(r->quads, len * sizeof(*q));
+		if (!q)
+			return (-1);
+		mem_alloc(MEM_FONTS, MEM_SHARED, (len - r->cap) * sizeof(*q));
+		r->quads = q;
+		r->cap   = len;
+	}
+
+	off_x = 0.0f;
+	off_y = 0;
+
+	for (i = 0; i < len; i += bytes)
+	{
+		bytes = 0;
+		cp    = GetCodepoint(&text[i], &bytes);
+		idx   = GetGlyphIndex(font, cp);
+
+		/* Invalid sequence, skip a byte. */
+		if (cp == 0x3f)
+			bytes = 1;
+
+		if (cp == '\n')
+		{
+			off_y += (int)((font.baseSize + font.baseSize/2)*scale);
+			off_x  = 0.0f;
+			continue;
+		}
+
+		if (cp != ' ' && cp != '\t')
+		{
+			q = &r->quads[r->count++];
+			q->x  = off_x + (font.chars[idx].offsetX - font.charsPadding)*scale;
+			q->y  = off_y + (font.chars[idx].offsetY - font.charsPadding)*scale;
+			q->w  = (font.recs[idx].width  + 2.0f*font.charsPadding)*scale;
+			q->h  = (font.recs[idx].height + 2.0f*font.charsPadding)*scale;
+			q->u0 = (font.recs[idx].x - font.charsPadding) / font.texture.width;
+			q->v0 = (font.recs[idx].y - font.charsPadding) / font.texture.height;
+			q->u1 = q->u0 + (font.recs[idx].width + 2.0f*font.charsPadding) /
+				font.texture.width;
+			q->v1 = q->v0 + (font.recs[idx].height + 2.0f*font.charsPadding) /
+				font.texture.height;
+		}
+
+		if (font.chars[idx].advanceX)
+			off_x += font.chars[idx].advanceX*scale + spacing;
+		else
+			off_x += font.recs[idx].width*scale + spacing;
+	}
+
+	r->width = MeasureText(text, size);
+	return (0);
+}
+
+/**
+ * Returns the laid out @p text at @p size, from the cache if
+ * possible, or NULL if it can not be cached.
+ */
+static struct text_run *get_run(const char *text, int size)
+{
+	struct text_run *r;
+	uint64_t key;
+	size_t len;
+
+	len = strlen(text);
+	if (len >= TEXT_MAX_LEN)
+		return (NULL);
+
+	key = text_key(text, size);
+	r   = &cache[key % TEXT_CACHE_SLOTS];
+
+	if (r->key == key && r->size == size && !strcmp(r->text, text))
+		return (r);
+
+	r->key = 0;
+	if (layout(r, text, size) < 0)
+		return (NULL);
+
+	memcpy(r->text, text, len + 1);
+	r->key  = key;
+	r->size = size;
+	return (r);
+}
+
+/**
+ * Emit the quads of @p r at (@p x, @p y), from the texture @p tex,
+ * grown by @p pad texels (of the default font) on each side.
+ */
+static void emit(const struct text_run *r, Texture2D tex, float x, float y,
+	float pad, Color color)
+{
+	const struct glyph_quad *q;
+	float scale;
+	float pu, pv;
+	float px;
+	int i;
+
+	scale = (float)(r->size < DEFAULT_FONT_SIZE ?
+		DEFAULT_FONT_SIZE : r->size) / GetFontDefault().baseSize;
+	px = pad * scale;
+	pu = pad / GetFontDefault().texture.width;
+	pv = pad / GetFontDefault().texture.height;
+
+	for (i = 0; i < r->count; i++)
+	{
+		q = &r->quads[i];
+
+		rlCheckRenderBatchLimit(4);
+		rlSetTexture(tex.id);
+		rlBegin(RL_QUADS);
+
+			rlColor4ub(color.r, color.g, color.b, color.a);
+			rlNormal3f(0.0f, 0.0f, 1.0f);
+
+			rlTexCoord2f(q->u0 - pu, q->v0 - pv);
+			rlVertex2f(x + q->x - px, y + q->y - px);
+			rlTexCoord2f(q->u0 - pu, q->v1 + pv);
+			rlVertex2f(x + q->x - px, y + q->y + q->h + px);
+			rlTexCoord2f(q->u1 + pu, q->v1 + pv);
+			rlVertex2f(x + q->x + q->w + px, y + q->y + q->h + px);
+			rlTexCoord2f(q->u1 + pu, q->v0 - pv);
+			rlVertex2f(x + q->x + q->w + px, y + q->y - px);
+
+		rlEnd();
+	}
+
+	rlSetTexture(0);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Public routines                                                           */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Build the SDF font; text is drawn with the default font only
+ * if that fails.
+ */
+void init_text_cache(void)
+{
+	float smoothing = 1.0f;
+	int loc;
+
+	if (build_sdf_texture() < 0)
+	{
+		TraceLog(LOG_WARNING, "Unable to build the SDF font");
+		return;
+	}
+
+	sdf_shader = LoadShaderFromMemory(NULL, sdf_fragment_shader);
+	loc = GetShaderLocation(sdf_shader, "smoothing");
+
+	/* Build failed: raylib falls back to its default shader. */
+	if (loc < 0)
+	{
+		TraceLog(LOG_WARNING, "Unable to build the SDF font shader");
+		UnloadShader(sdf_shader);
+		mem_free(MEM_FONTS|MEM_GPU, MEM_SHARED, sdf_texture_size());
+		UnloadTexture(sdf_texture);
+		return;
+	}
+
+	SetShaderValue(sdf_shader, loc, &smoothing, SHADER_UNIFORM_FLOAT);
+	sdf_ready = true;
+}
+
+/**
+ * Release the cache and the SDF font.
+ */
+void finish_text_cache(void)
+{
+	int i;
+
+	for (i = 0; i < TEXT_CACHE_SLOTS; i++)
+	{
+		mem_free(MEM_FONTS, MEM_SHARED, cache[i].cap *
+			sizeof(*cache[i].quads));
+		free(cache[i].quads);
+		cache[i].quads = NULL;
+		cache[i].cap   = 0;
+		cache[i].key   = 0;
+	}
+
+	if (sdf_ready)
+	{
+		UnloadShader(sdf_shader);
+		mem_free(MEM_FONTS|MEM_GPU, MEM_SHARED, sdf_texture_size());
+		UnloadTexture(sdf_texture);
+		sdf_ready = false;
+	}
+}
+
+/**
+ * Draw @p text at (@p x, @p y), like DrawText().
+ */
+void draw_text(const char *text, int x, int y, int size, Color color)
+{
+	struct text_run *r;
+
+	if (!(r = get_run(text, size)))
+	{
+		DrawText(text, x, y, size, color);
+		return;
+	}
+
+	if (size < TEXT_SDF_MIN_SIZE || !sdf_ready)
+	{
+		emit(r, GetFontDefault().texture, (float)x, (float)y, 0.0f, color);
+		return;
+	}
+
+	/* Half a texel of margin, for the smoothed edges. */
+	BeginShaderMode(sdf_shader);
+		emit(r, sdf_texture, (float)x, (float)y, 0.5f, color);
+	EndShaderMode();
+}
+
+/**
+ * Returns the width of @p text, like MeasureText().
+ */
+int measure_text(const char *text, int size)
+{
+	struct text_run *r;
+
+	if (!(r = get_run(text, size)))
+		return (MeasureText(text, size));
+
+	return (r->width);
+}
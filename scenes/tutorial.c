@@ -25,40 +25,32 @@
 #include <stdlib.h>
 #include "raylib.h"
 #include "scenes.h"
+#include "scene_mgr.h"
+#include "layers.h"
+#include "sprites.h"
+#include "text_cache.h"
 
 /* Tutorial global vars. */
-static Texture2D pc;
-static Texture2D user;
 static Rectangle  rec_pc;
 static Rectangle  rec_user;
 static Rectangle *rec_sel;
 
 /**
- * Load tutorial resources.
+ * Enter the tutorial.
  */
-void init_tutorial(void)
+void enter_tutorial(void)
 {
-	pc   = LoadTexture("resources/monitor.png");
-	user = LoadTexture("resources/user.png");
+	init_gear();
 
 	rec_pc.x      = TUTORIAL_PC_X;
 	rec_pc.y      = TUTORIAL_PC_Y;
-	rec_pc.width  = pc.width;
-	rec_pc.height = pc.height;
+	rec_pc.width  = sprite_rect(SPRITE_MONITOR).width;
+	rec_pc.height = sprite_rect(SPRITE_MONITOR).height;
 
 	rec_user.x      = TUTORIAL_USER_X;
 	rec_user.y      = TUTORIAL_USER_Y;
-	rec_user.width  = user.width;
-	rec_user.height = user.height;
-}
-
-/**
- * Free tutorial resources.
- */
-void finish_tutorial(void)
-{
-	UnloadTexture(pc);
-	UnloadTexture(user);
+	rec_user.width  = sprite_rect(SPRITE_USER).width;
+	rec_user.height = sprite_rect(SPRITE_USER).height;
 }
 
 /**
@@ -77,14 +69,12 @@ void update_tutorial_logic(void)
 	/* If mouse click, starts game play */
 	if (IsClick() && rec_sel)
 	{
-		global_state = STATE_INGAME;
 		if (rec_sel == &rec_user)
 			turn = PLAYER_TURN;
 		else
 			turn = COMPUTER_TURN;
 
-		/* Initialize sticks amount. */
-		setup_crystals_amount();
+		change_scene(SCENE_INGAME);
 	}
 
 	/* Gear logic. */
@@ -92,24 +82,44 @@ void update_tutorial_logic(void)
 }
 
 /**
- * Update game drawing, i.e: draws a single frame.
+ * Mix into @p key everything the tutorial layer depends on.
  */
-void update_tutorial_drawing(void)
+uint64_t tutorial_layer_key(uint64_t key)
+{
+	return (gear_layer_key(key));
+}
+
+/**
+ * Draw the static part of the tutorial (cached in the screen
+ * layer): rules and gear window.
+ */
+void draw_tutorial_layer(void)
 {
 	/* Draw rules. */
-	DrawText("The NIM game consists of removing the sticks from the "
+	draw_text("The NIM game consists of removing the sticks from the "
 		"table, the amount\nyou want, a single row per time. The last "
 		"to remove the sticks, LOSES!!\nGood Luck!!!", START_X,
 		TUTORIAL_START_Y, TUTORIAL_SIZE, BLACK);
 
 
-	DrawText("Who starts?:", START_X, TUTORIAL_START_Y + 100, TUTORIAL_SIZE,
+	draw_text("Who starts?:", START_X, TUTORIAL_START_Y + 100, TUTORIAL_SIZE,
 		BLACK);
-	DrawTexture(pc,   TUTORIAL_PC_X, TUTORIAL_PC_Y, WHITE);
-	DrawTexture(user, TUTORIAL_USER_X, TUTORIAL_USER_Y, WHITE);
+
+	/* Gear menu. */
+	draw_gear_layer();
+}
+
+/**
+ * Update game drawing, i.e: draws a single frame.
+ */
+void update_tutorial_drawing(void)
+{
+	draw_sprite(SPRITE_MONITOR, TUTORIAL_PC_X, TUTORIAL_PC_Y, WHITE);
+	draw_sprite(SPRITE_USER, TUTORIAL_USER_X, TUTORIAL_USER_Y, WHITE);
 
 	if (rec_sel)
 	{
+		flush_sprites();
 		DrawRectangleRec(*rec_sel, ColorAlpha(LIGHT_BLUE, 0.6f));
 		DrawLineEx(
 			((Vector2){.x=rec_sel->x, .y=rec_sel->y + rec_sel->height}),
@@ -117,6 +127,6 @@ void update_tutorial_drawing(void)
 				rec_sel->height}), 2, BLUE);
 	}
 
-	/* Gear button & menu. */
+	/* Gear button (the menu is in the layer). */
 	update_gear_drawing();
 }
@@ -0,0 +1,137 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tween.h"
+
+/**
+ * Apply the easing curve @p ease to @p x (0-1).
+ */
+static float ease(int ease, float x)
+{
+	switch (ease)
+	{
+		case EASE_IN_QUAD:
+			return (x * x);
+		case EASE_OUT_QUAD:
+			return (x * (2.0f - x));
+		case EASE_IN_OUT_QUAD:
+			return (x < 0.5f ? 2.0f * x * x : -1.0f + (4.0f - 2.0f * x) * x);
+		case EASE_OUT_CUBIC:
+			x -= 1.0f;
+			return (x * x * x + 1.0f);
+		default:
+			return (x);
+	}
+}
+
+/**
+ * Start the tween @p t, going from @p from to @p to in @p duration
+ * seconds with the easing curve @p ease.
+ *
+ * With TWEEN_PING_PONG, @p t goes back and forth forever.
+ */
+void tween_start(struct tween *t, float from, float to, float duration,
+	int ease, int mode)
+{
+	t->from     = from;
+	t->to       = to;
+	t->duration = duration;
+	t->elapsed  = 0.0;
+	t->ease     = ease;
+	t->mode     = mode;
+	t->done     = (duration <= 0.0f);
+}
+
+/**
+ * Advance @p t by @p dt seconds.
+ *
+ * Returns 1 if the tween has just finished (or, for ping-pong
+ * tweens, reached an end), 0 otherwise.
+ */
+int tween_update(struct tween *t, float dt)
+{
+	float tmp;
+
+	if (t->done)
+		return (0);
+
+	t->elapsed += dt;
+	if (t->elapsed < t->duration - TWEEN_EPSILON)
+		return (0);
+
+	if (t->mode == TWEEN_PING_PONG)
+	{
+		t->elapsed -= t->duration;
+		tmp     = t->from;
+		t->from = t->to;
+		t->to   = tmp;
+	}
+	else
+	{
+		t->elapsed = t->duration;
+		t->done    = 1;
+	}
+	return (1);
+}
+
+/**
+ * Returns the current value of @p t.
+ */
+float tween_value(const struct tween *t)
+{
+	float x;
+
+	if (t->duration <= 0.0f)
+		return (t->to);
+
+	x = (float)(t->elapsed / t->duration);
+	if (x > 1.0f)
+		x = 1.0f;
+	if (x < 0.0f)
+		x = 0.0f;
+
+	return (t->from + (t->to - t->from) * ease(t->ease, x));
+}
+
+/**
+ * Accumulate @p frame_time seconds in @p c.
+ *
+ * Returns the amount of TWEEN_STEP steps to run this frame.
+ */
+int tween_clock_steps(struct tween_clock *c, float frame_time)
+{
+	int steps;
+
+	if (frame_time > TWEEN_MAX_FRAME)
+		frame_time = TWEEN_MAX_FRAME;
+	if (frame_time < 0.0f)
+		frame_time = 0.0f;
+
+	/* In double, with exact steps: no drift over time. */
+	c->acc += frame_time;
+	for (steps = 0; c->acc >= 1.0 / TWEEN_HZ - TWEEN_EPSILON; steps++)
+		c->acc -= 1.0 / TWEEN_HZ;
+
+	return (steps);
+}
@@ -0,0 +1,290 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+
+/*
+ * Build-time texture atlas packer.
+ *
+ * Packs the given images (RGBA, PNG) into a single atlas image,
+ * and writes a header with one SPRITE_<NAME> index per image
+ * (named after the file) and the rectangles of each one of them
+ * within the atlas, see include/atlas_uv.h.
+ *
+ * The sprites are packed in shelves, tallest first, into a 256
+ * pixels wide atlas; the height is rounded up to a power of two.
+ *
+ * The atlas is mipmapped (see tools/res_embed.c) and sampled with
+ * trilinear filtering, so the sprites must not share a texel on
+ * any of the first ATLAS_MIP_LEVELS levels: each one starts at a
+ * multiple of ATLAS_ALIGN pixels (the texel size of the last of
+ * those levels), its edges are extruded up to the next multiple
+ * and a transparent gap of ATLAS_ALIGN pixels follows. The crystals
+ * collapse into badges below a 1/16 zoom, i.e: past level 4.
+ *
+ * Usage:
+ *   atlas_pack -o atlas.png -H atlas_uv.h sprite1.png sprite2.png...
+ */
+
+#define ATLAS_WIDTH      256
+#define ATLAS_MIP_LEVELS 5
+#define ATLAS_ALIGN      (1 << (ATLAS_MIP_LEVELS - 1))
+#define MAX_SPRITES      64
+#define MAX_NAME         64
+
+/*
+ * Sprite being packed.
+ */
+struct sprite
+{
+	char name[MAX_NAME];
+	Image img;
+	int x;
+	int y;
+};
+
+static struct sprite sprites[MAX_SPRITES];
+static int order[MAX_SPRITES];
+static int nsprites;
+
+/**
+ * Abort with an error message.
+ */
+static void die(const char *msg, const char *arg)
+{
+	fprintf(stderr, "atlas_pack: %s%s\n", msg, arg ? arg : "");
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * Sprite name from its file path: basename, without extension,
+ * upper case.
+ */
+static void sprite_name(char *name, const char *path)
+{
+	const char *base;
+	int i;
+
+	base = strrchr(path, '/');
+	base = base ? base + 1 : path;
+
+	for (i = 0; base[i] && base[i] != '.' && i < MAX_NAME - 1; i++)
+		name[i] = isalnum((unsigned char)base[i]) ?
+			(char)toupper((unsigned char)base[i]) : '_';
+	name[i] = '\0';
+}
+
+/**
+ * Sort by height (descending), keeping the command line order
+ * for the same height.
+ */
+static int cmp_height(const void *a, const void *b)
+{
+	const int ia = *(const int *)a;
+	const int ib = *(const int *)b;
+
+	if (sprites[ia].img.height != sprites[ib].img.height)
+		return (sprites[ib].img.height - sprites[ia].img.height);
+	return (ia - ib);
+}
+
+/**
+ * Round @p v up to a multiple of ATLAS_ALIGN.
+ */
+static int align(int v)
+{
+	return ((v + ATLAS_ALIGN - 1) & ~(ATLAS_ALIGN - 1));
+}
+
+/**
+ * Shelf packing.
+ *
+ * Returns the atlas height.
+ */
+static int pack(void)
+{
+	int height;
+	int shelf;
+	int x;
+	int y;
+	int i;
+
+	for (i = 0; i < nsprites; i++)
+		order[i] = i;
+	qsort(order, nsprites, sizeof(*order), cmp_height);
+
+	x = y = shelf = 0;
+	for (i = 0; i < nsprites; i++)
+	{
+		struct sprite *s = &sprites[order[i]];
+
+		if (s->img.width > ATLAS_WIDTH)
+			die("sprite too wide: ", s->name);
+
+		/* Next shelf. */
+		if (x + s->img.width > ATLAS_WIDTH)
+		{
+			y += align(shelf) + ATLAS_ALIGN;
+			x = shelf = 0;
+		}
+
+		s->x = x;
+		s->y = y;
+		x += align(s->img.width) + ATLAS_ALIGN;
+		if (s->img.height > shelf)
+			shelf = s->img.height;
+	}
+
+	for (height = 1; height < y + shelf; height <<= 1);
+	return (height);
+}
+
+/**
+ * Write the UV header @p path.
+ */
+static void write_header(const char *path, const char *atlas, int height)
+{
+	FILE *f;
+	int i;
+
+	if (!(f = fopen(path, "w")))
+		die("unable to create ", path);
+
+	fprintf(f,
+		"/* Generated by tools/atlas_pack.c, do not edit. */\n\n"
+		"#ifndef ATLAS_UV_H\n"
+		"#define ATLAS_UV_H\n\n"
+		"\t#define ATLAS_FILE   \"%s\"\n"
+		"\t#define ATLAS_WIDTH  %d\n"
+		"\t#define ATLAS_HEIGHT %d\n\n"
+		"\t/* Sprites. */\n", atlas, ATLAS_WIDTH, height);
+
+	for (i = 0; i < nsprites; i++)
+		fprintf(f, "\t#define SPRITE_%-8s %d\n", sprites[i].name, i);
+	fprintf(f, "\t#define SPRITE_%-8s %d\n\n", "COUNT", nsprites);
+
+	fprintf(f, "\t/* Sprite rectangles (x, y, width, height), in pixels. */\n"
+		"\t#define ATLAS_RECTS \\\n");
+	for (i = 0; i < nsprites; i++)
+	{
+		fprintf(f, "\t\t{ %3d, %3d, %3d, %3d }%s\n", sprites[i].x,
+			sprites[i].y, sprites[i].img.width, sprites[i].img.height,
+			i < nsprites - 1 ? ", \\" : "");
+	}
+
+	fprintf(f, "\n#endif /* ATLAS_UV_H. */\n");
+	if (fclose(f))
+		die("unable to write ", path);
+}
+
+/**
+ * Main routine.
+ */
+int main(int argc, char **argv)
+{
+	const char *header;
+	const char *out;
+	unsigned char *dst;
+	unsigned char *src;
+	Image atlas;
+	int height;
+	int row;
+	int col;
+	int w, h;
+	int i;
+
+	out = header = NULL;
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-o") && i + 1 < argc)
+			out = argv[++i];
+		else if (!strcmp(argv[i], "-H") && i + 1 < argc)
+			header = argv[++i];
+		else if (nsprites == MAX_SPRITES)
+			die("too many sprites", NULL);
+		else
+		{
+			sprite_name(sprites[nsprites].name, argv[i]);
+			sprites[nsprites].img = LoadImage(argv[i]);
+			if (!sprites[nsprites].img.data)
+				die("unable to load ", argv[i]);
+			ImageFormat(&sprites[nsprites].img,
+				PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+			nsprites++;
+		}
+	}
+
+	if (!out || !header || !nsprites)
+	{
+		fprintf(stderr, "Usage: %s -o atlas.png -H atlas_uv.h sprites...\n",
+			argv[0]);
+		return (EXIT_FAILURE);
+	}
+
+	height = pack();
+
+	/* Plain copy, no blending. */
+	atlas.width   = ATLAS_WIDTH;
+	atlas.height  = height;
+	atlas.mipmaps = 1;
+	atlas.format  = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+	atlas.data    = calloc((size_t)ATLAS_WIDTH * height, 4);
+	if (!atlas.data)
+		die("out of memory", NULL);
+
+	for (i = 0; i < nsprites; i++)
+	{
+		struct sprite *s = &sprites[i];
+		w = align(s->img.width);
+		h = align(s->img.height);
+
+		/* Copy, extruding the right and bottom edges up to (w, h). */
+		for (row = 0; row < h && s->y + row < height; row++)
+		{
+			dst = (unsigned char *)atlas.data +
+				((size_t)(s->y + row) * ATLAS_WIDTH + s->x) * 4;
+			src = (unsigned char *)s->img.data + (size_t)(row <
+				s->img.height ? row : s->img.height - 1) * s->img.width * 4;
+			memcpy(dst, src, (size_t)s->img.width * 4);
+
+			for (col = s->img.width; col < w && s->x + col < ATLAS_WIDTH;
+				col++)
+			{
+				memcpy(dst + col * 4, src + (s->img.width - 1) * 4, 4);
+			}
+		}
+		UnloadImage(s->img);
+	}
+
+	if (!ExportImage(atlas, out))
+		die("unable to write ", out);
+	free(atlas.data);
+
+	write_header(header, out, height);
+	return (EXIT_SUCCESS);
+}
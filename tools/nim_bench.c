@@ -0,0 +1,178 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "nim.h"
+#include "nim_rand.h"
+
+/*
+ * Solver benchmark: measures how many positions per second
+ * nim_best_move() solves, for each SIMD level supported by
+ * the running CPU, against the scalar baseline.
+ *
+ * The generated positions are the worst case for the solver:
+ * the only heap that can be reduced is the last one, so all the
+ * three passes (xor, count and search) go through every heap.
+ */
+
+/* Defaults. */
+#define DEFAULT_HEAPS     (1 << 20)
+#define DEFAULT_POSITIONS 256
+#define DEFAULT_SEED      0x5EEDULL
+
+/* Options. */
+static size_t nheaps    = DEFAULT_HEAPS;
+static size_t positions = DEFAULT_POSITIONS;
+static uint64_t seed    = DEFAULT_SEED;
+
+/**
+ * Returns the current monotonic time, in seconds.
+ */
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((double)ts.tv_sec + (double)ts.tv_nsec * 1e-9);
+}
+
+/**
+ * Show program usage.
+ */
+static void usage(const char *prg)
+{
+	fprintf(stderr,
+		"Usage: %s [-n heaps] [-p positions] [-s seed]\n"
+		"  -n heaps      amount of heaps per position (default: %d)\n"
+		"  -p positions  amount of positions to solve (default: %d)\n"
+		"  -s seed       seed for the heaps generation\n",
+		prg, DEFAULT_HEAPS, DEFAULT_POSITIONS);
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * Solve @p positions times the position @p pos with the SIMD
+ * level @p level and report the throughput.
+ *
+ * Returns the positions per second achieved, or 0 if the level
+ * is not supported.
+ */
+static double run(int level, struct nim_position *pos,
+	struct nim_move *move)
+{
+	struct nim_move m;
+	double start;
+	double elapsed;
+	size_t i;
+
+	if (nim_simd_select(level) != level)
+		return (0.0);
+
+	start = now();
+	for (i = 0; i < positions; i++)
+		nim_best_move(pos, &m);
+	elapsed = now() - start;
+
+	/* All the kernels must agree. */
+	if (level == NIM_SIMD_SCALAR)
+		*move = m;
+	else if (m.heap != move->heap || m.amount != move->amount)
+	{
+		fprintf(stderr, "%s: mismatch: heap %zu, amount %" PRIu64 "\n",
+			nim_simd_name(), m.heap, m.amount);
+		exit(EXIT_FAILURE);
+	}
+
+	return ((double)positions / elapsed);
+}
+
+/**
+ * Main routine.
+ */
+int main(int argc, char **argv)
+{
+	struct nim_position pos;
+	struct nim_move move;
+	struct nim_rand rng;
+	double scalar;
+	double pps;
+	int level;
+	int c;
+
+	while ((c = getopt(argc, argv, "n:p:s:")) != -1)
+	{
+		switch (c)
+		{
+			case 'n':
+				nheaps = strtoull(optarg, NULL, 10);
+				break;
+			case 'p':
+				positions = strtoull(optarg, NULL, 10);
+				break;
+			case 's':
+				seed = strtoull(optarg, NULL, 0);
+				break;
+			default:
+				usage(argv[0]);
+		}
+	}
+
+	if (!nheaps || !positions)
+		usage(argv[0]);
+
+	pos.nheaps = nheaps;
+	pos.heaps  = malloc(nheaps * sizeof(*pos.heaps));
+	if (!pos.heaps)
+	{
+		fprintf(stderr, "Unable to allocate %zu heaps\n", nheaps);
+		return (EXIT_FAILURE);
+	}
+
+	/* Small heaps, except the last one. */
+	nim_rand_seed(&rng, seed);
+	nim_rand_boards(&rng, pos.heaps, 1, nheaps, 0, UINT32_MAX);
+	pos.heaps[nheaps - 1] |= 1ULL << 48;
+
+	printf("heaps: %zu, positions: %zu\n", nheaps, positions);
+
+	scalar = 0.0;
+	for (level = NIM_SIMD_SCALAR; level <= NIM_SIMD_WASM; level++)
+	{
+		if (!(pps = run(level, &pos, &move)))
+			continue;
+		if (level == NIM_SIMD_SCALAR)
+			scalar = pps;
+
+		printf("  %-8s %14.2f positions/s  (%.2fx)\n", nim_simd_name(),
+			pps, pps / scalar);
+	}
+
+	free(pos.heaps);
+	return (EXIT_SUCCESS);
+}
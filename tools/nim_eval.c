@@ -0,0 +1,634 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "nim.h"
+
+/*
+ * Batch position evaluator.
+ *
+ * Reads positions from a file (or stdin) and, for each one of
+ * them, outputs whether the player to move is winning or losing
+ * and the move the computer would play.
+ *
+ * Input formats:
+ * - Text (default): one position per line, heap sizes separated
+ *   by spaces, tabs or commas.
+ *
+ * - Binary (-b): for each position, an uint32_t with the amount
+ *   of heaps followed by the heaps, as uint64_t; all of them in
+ *   native (little-endian) byte order.
+ *
+ * Output formats:
+ * - Text (default): one line per position: 'W' or 'L', followed
+ *   by the heap index (0-based) and the amount to remove, or '-'
+ *   if there is no move left. Malformed lines output 'E - -'.
+ *
+ * - Binary (-B): for each position, an uint8_t (1: winning,
+ *   0: losing, 0xFF: malformed) followed by the heap index and
+ *   amount as uint64_t (both UINT64_MAX if there is no move).
+ *
+ * The input is read in chunks; each chunk is split among the
+ * worker threads, each one writing into its own output buffer,
+ * and the buffers are written in order, so the output order
+ * matches the input. The next chunk is read while the current
+ * one is being evaluated.
+ */
+
+/* Defaults. */
+#define DEFAULT_CHUNK_SIZE (8 << 20)
+#define MAX_THREADS        256
+
+/* Binary records. */
+#define BIN_HDR_SIZE  (sizeof(uint32_t))
+#define BIN_OUT_SIZE  (1 + 2 * sizeof(uint64_t))
+#define BIN_MALFORMED 0xFF
+
+/* Options. */
+static int binary_in;
+static int binary_out;
+static int verbose;
+static int nthreads;
+static size_t chunk_size = DEFAULT_CHUNK_SIZE;
+
+/*
+ * Input chunk.
+ */
+struct chunk
+{
+	char *data;
+	size_t len;   /* Bytes read.                   */
+	size_t used;  /* Bytes with complete records.  */
+	size_t cap;   /* Buffer capacity.              */
+};
+
+/*
+ * Worker thread, with its own slice of the current chunk,
+ * output buffer and heaps scratch.
+ */
+struct worker
+{
+	pthread_t tid;
+	const char *start;
+	const char *end;
+	char *out;
+	size_t out_len;
+	size_t out_cap;
+	uint64_t *heaps;
+	size_t heaps_cap;
+	uint64_t positions;
+	uint64_t malformed;
+};
+
+static struct worker workers[MAX_THREADS];
+
+/* Pool synchronization. */
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  pool_work  = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  pool_done  = PTHREAD_COND_INITIALIZER;
+static unsigned pool_generation;
+static int pool_pending;
+static int pool_quit;
+
+/* ---------------------------------------------------------------------- */
+/* Helpers.                                                               */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Abort with an error message.
+ */
+static void die(const char *msg)
+{
+	fprintf(stderr, "nim_eval: %s\n", msg);
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * Ensure that @p *buf has room for at least @p need bytes.
+ */
+static void *reserve(void *buf, size_t *cap, size_t need, size_t elem)
+{
+	size_t new_cap;
+
+	if (need <= *cap)
+		return (buf);
+
+	new_cap = *cap ? *cap : 64;
+	while (new_cap < need)
+		new_cap <<= 1;
+
+	if (!(buf = realloc(buf, new_cap * elem)))
+		die("out of memory");
+
+	*cap = new_cap;
+	return (buf);
+}
+
+/**
+ * Returns the current monotonic time, in seconds.
+ */
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((double)ts.tv_sec + (double)ts.tv_nsec * 1e-9);
+}
+
+/* ---------------------------------------------------------------------- */
+/* Evaluation.                                                            */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Evaluate a single position and append the result into the
+ * worker output buffer.
+ */
+static void emit(struct worker *w, size_t nheaps, int malformed)
+{
+	struct nim_position pos;
+	struct nim_move move;
+	uint64_t heap;
+	uint8_t res;
+	int has_move;
+	char *p;
+
+	pos.heaps  = w->heaps;
+	pos.nheaps = nheaps;
+
+	has_move = 0;
+	res = BIN_MALFORMED;
+	if (!malformed)
+	{
+		res = (uint8_t)nim_is_winning(&pos);
+		has_move = (nim_best_move(&pos, &move) == 0);
+	}
+
+	w->positions++;
+	w->malformed += (malformed != 0);
+
+	if (binary_out)
+	{
+		w->out = reserve(w->out, &w->out_cap, w->out_len + BIN_OUT_SIZE, 1);
+		p = w->out + w->out_len;
+
+		heap = has_move ? move.heap : UINT64_MAX;
+		if (!has_move)
+			move.amount = UINT64_MAX;
+
+		*p = (char)res;
+		memcpy(p + 1, &heap, sizeof(heap));
+		memcpy(p + 1 + sizeof(heap), &move.amount, sizeof(move.amount));
+		w->out_len += BIN_OUT_SIZE;
+		return;
+	}
+
+	/* 'W ' + 2 * (20 digits + 1) + NUL. */
+	w->out = reserve(w->out, &w->out_cap, w->out_len + 48, 1);
+	p = w->out + w->out_len;
+
+	if (malformed)
+		w->out_len += sprintf(p, "E - -\n");
+	else if (!has_move)
+		w->out_len += sprintf(p, "%c - -\n", res ? 'W' : 'L');
+	else
+		w->out_len += sprintf(p, "%c %zu %" PRIu64 "\n", res ? 'W' : 'L',
+			move.heap, move.amount);
+}
+
+/**
+ * Parse and evaluate the text positions of the worker slice.
+ */
+static void eval_text(struct worker *w)
+{
+	const char *p;
+	uint64_t value;
+	uint64_t digit;
+	size_t nheaps;
+	int malformed;
+	int in_number;
+
+	p = w->start;
+	while (p < w->end)
+	{
+		nheaps    = 0;
+		value     = 0;
+		malformed = 0;
+		in_number = 0;
+
+		for (; p < w->end && *p != '\n'; p++)
+		{
+			if (*p >= '0' && *p <= '9')
+			{
+				digit = (uint64_t)(*p - '0');
+				if (value > (UINT64_MAX - digit) / 10)
+					malformed = 1;
+				value = value * 10 + digit;
+				in_number = 1;
+			}
+			else if (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r')
+			{
+				if (!in_number)
+					continue;
+				w->heaps = reserve(w->heaps, &w->heaps_cap, nheaps + 1,
+					sizeof(*w->heaps));
+				w->heaps[nheaps++] = value;
+				value = 0;
+				in_number = 0;
+			}
+			else
+				malformed = 1;
+		}
+
+		if (in_number)
+		{
+			w->heaps = reserve(w->heaps, &w->heaps_cap, nheaps + 1,
+				sizeof(*w->heaps));
+			w->heaps[nheaps++] = value;
+		}
+
+		emit(w, nheaps, malformed);
+		p++; /* Skip '\n'. */
+	}
+}
+
+/**
+ * Evaluate the binary positions of the worker slice.
+ */
+static void eval_binary(struct worker *w)
+{
+	const char *p;
+	uint32_t nheaps;
+
+	for (p = w->start; p < w->end; p += nheaps * sizeof(uint64_t))
+	{
+		memcpy(&nheaps, p, sizeof(nheaps));
+		p += BIN_HDR_SIZE;
+
+		w->heaps = reserve(w->heaps, &w->heaps_cap, nheaps,
+			sizeof(*w->heaps));
+		memcpy(w->heaps, p, nheaps * sizeof(uint64_t));
+		emit(w, nheaps, 0);
+	}
+}
+
+/**
+ * Worker thread routine.
+ */
+static void *worker_routine(void *arg)
+{
+	struct worker *w = arg;
+	unsigned seen;
+
+	seen = 0;
+	for (;;)
+	{
+		pthread_mutex_lock(&pool_mutex);
+			while (pool_generation == seen && !pool_quit)
+				pthread_cond_wait(&pool_work, &pool_mutex);
+			if (pool_quit)
+			{
+				pthread_mutex_unlock(&pool_mutex);
+				break;
+			}
+			seen = pool_generation;
+		pthread_mutex_unlock(&pool_mutex);
+
+		if (binary_in)
+			eval_binary(w);
+		else
+			eval_text(w);
+
+		pthread_mutex_lock(&pool_mutex);
+			if (!--pool_pending)
+				pthread_cond_signal(&pool_done);
+		pthread_mutex_unlock(&pool_mutex);
+	}
+	return (NULL);
+}
+
+/* ---------------------------------------------------------------------- */
+/* Chunks.                                                                */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Returns the size of the binary record at @p p, or 0 if
+ * incomplete.
+ */
+static size_t bin_record_size(const char *p, size_t avail)
+{
+	uint32_t nheaps;
+	size_t size;
+
+	if (avail < BIN_HDR_SIZE)
+		return (0);
+
+	memcpy(&nheaps, p, sizeof(nheaps));
+	size = BIN_HDR_SIZE + (size_t)nheaps * sizeof(uint64_t);
+	return (size <= avail ? size : 0);
+}
+
+/**
+ * Returns the amount of bytes of @p c that contains only
+ * complete records.
+ */
+static size_t complete_bytes(const struct chunk *c, int eof)
+{
+	size_t off;
+	size_t size;
+
+	if (binary_in)
+	{
+		for (off = 0; (size = bin_record_size(c->data + off,
+			c->len - off)); off += size);
+
+		if (eof && off != c->len)
+			die("truncated binary record at end of input");
+		return (off);
+	}
+
+	if (eof)
+		return (c->len);
+
+	for (off = c->len; off > 0; off--)
+		if (c->data[off - 1] == '\n')
+			break;
+	return (off);
+}
+
+/**
+ * Read the next chunk of input into @p dst, starting with the
+ * incomplete tail left by @p prev.
+ *
+ * Returns 1 if there is something to evaluate, 0 otherwise.
+ */
+static int read_chunk(FILE *in, struct chunk *dst, const struct chunk *prev)
+{
+	size_t tail;
+	size_t rd;
+	int eof;
+
+	tail = prev ? prev->len - prev->used : 0;
+	dst->data = reserve(dst->data, &dst->cap, chunk_size > tail ?
+		chunk_size : tail, 1);
+
+	if (tail)
+		memcpy(dst->data, prev->data + prev->used, tail);
+	dst->len = tail;
+
+	eof = 0;
+	for (;;)
+	{
+		while (dst->len < dst->cap)
+		{
+			rd = fread(dst->data + dst->len, 1, dst->cap - dst->len, in);
+			if (!rd)
+			{
+				if (ferror(in))
+					die(strerror(errno));
+				eof = 1;
+				break;
+			}
+			dst->len += rd;
+		}
+
+		dst->used = complete_bytes(dst, eof);
+
+		/* A single record bigger than the chunk: grow it. */
+		if (!dst->used && !eof)
+		{
+			dst->data = reserve(dst->data, &dst->cap, dst->cap << 1, 1);
+			continue;
+		}
+		break;
+	}
+
+	return (dst->used > 0);
+}
+
+/**
+ * Split the complete records of @p c among the workers.
+ */
+static void split_chunk(const struct chunk *c)
+{
+	const char *end;
+	const char *p;
+	size_t target;
+	size_t size;
+	int i;
+
+	p   = c->data;
+	end = c->data + c->used;
+
+	for (i = 0; i < nthreads; i++)
+	{
+		workers[i].start   = p;
+		workers[i].out_len = 0;
+		target = (c->used * (size_t)(i + 1)) / (size_t)nthreads;
+
+		if (i == nthreads - 1)
+			p = end;
+		else if (binary_in)
+		{
+			while (p < c->data + target &&
+				(size = bin_record_size(p, (size_t)(end - p))))
+			{
+				p += size;
+			}
+		}
+		else
+		{
+			if (p < c->data + target)
+				p = c->data + target;
+			while (p > c->data && p < end && p[-1] != '\n')
+				p++;
+		}
+
+		workers[i].end = p;
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+/* Main.                                                                  */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Show program usage.
+ */
+static void usage(const char *prg)
+{
+	fprintf(stderr,
+		"Usage: %s [options] [input-file]\n"
+		"Reads positions from input-file (or stdin) and outputs the\n"
+		"classification and best move for each one of them.\n\n"
+		"Options:\n"
+		"  -b          binary input (uint32 count + uint64 heaps)\n"
+		"  -B          binary output (uint8 result + uint64 heap, amount)\n"
+		"  -j threads  amount of worker threads (default: online CPUs)\n"
+		"  -c size     chunk size, in KiB (default: %d)\n"
+		"  -o file     output file (default: stdout)\n"
+		"  -v          print throughput statistics to stderr\n",
+		prg, DEFAULT_CHUNK_SIZE >> 10);
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * Main routine.
+ */
+int main(int argc, char **argv)
+{
+	struct chunk chunks[2] = {0};
+	uint64_t malformed;
+	uint64_t positions;
+	const char *out_file;
+	FILE *out;
+	FILE *in;
+	double start;
+	double elapsed;
+	int more;
+	int cur;
+	int c;
+	int i;
+
+	out_file = NULL;
+	while ((c = getopt(argc, argv, "bBj:c:o:v")) != -1)
+	{
+		switch (c)
+		{
+			case 'b':
+				binary_in = 1;
+				break;
+			case 'B':
+				binary_out = 1;
+				break;
+			case 'j':
+				nthreads = atoi(optarg);
+				break;
+			case 'c':
+				chunk_size = strtoull(optarg, NULL, 10) << 10;
+				break;
+			case 'o':
+				out_file = optarg;
+				break;
+			case 'v':
+				verbose = 1;
+				break;
+			default:
+				usage(argv[0]);
+		}
+	}
+
+	if (!nthreads)
+		nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (nthreads < 1 || nthreads > MAX_THREADS || !chunk_size)
+		usage(argv[0]);
+
+	in = stdin;
+	if (optind < argc && !(in = fopen(argv[optind], "rb")))
+		die(strerror(errno));
+
+	out = stdout;
+	if (out_file && !(out = fopen(out_file, "wb")))
+		die(strerror(errno));
+
+	for (i = 0; i < nthreads; i++)
+		if (pthread_create(&workers[i].tid, NULL, worker_routine, &workers[i]))
+			die("unable to create worker threads");
+
+	start = now();
+	cur   = 0;
+	more  = read_chunk(in, &chunks[cur], NULL);
+
+	while (more)
+	{
+		/* Dispatch current chunk. */
+		split_chunk(&chunks[cur]);
+		pthread_mutex_lock(&pool_mutex);
+			pool_pending = nthreads;
+			pool_generation++;
+			pthread_cond_broadcast(&pool_work);
+		pthread_mutex_unlock(&pool_mutex);
+
+		/* Read the next one meanwhile. */
+		more = read_chunk(in, &chunks[!cur], &chunks[cur]);
+
+		pthread_mutex_lock(&pool_mutex);
+			while (pool_pending)
+				pthread_cond_wait(&pool_done, &pool_mutex);
+		pthread_mutex_unlock(&pool_mutex);
+
+		/* Write results, in order. */
+		for (i = 0; i < nthreads; i++)
+			if (fwrite(workers[i].out, 1, workers[i].out_len, out) !=
+				workers[i].out_len)
+			{
+				die(strerror(errno));
+			}
+
+		cur = !cur;
+	}
+
+	pthread_mutex_lock(&pool_mutex);
+		pool_quit = 1;
+		pthread_cond_broadcast(&pool_work);
+	pthread_mutex_unlock(&pool_mutex);
+
+	positions = malformed = 0;
+	for (i = 0; i < nthreads; i++)
+	{
+		pthread_join(workers[i].tid, NULL);
+		positions += workers[i].positions;
+		malformed += workers[i].malformed;
+		free(workers[i].out);
+		free(workers[i].heaps);
+	}
+
+	if (fflush(out))
+		die(strerror(errno));
+
+	elapsed = now() - start;
+	if (verbose)
+	{
+		fprintf(stderr, "positions: %" PRIu64 " (%" PRIu64 " malformed), "
+			"threads: %d, kernels: %s\n", positions, malformed, nthreads,
+			nim_simd_name());
+		fprintf(stderr, "elapsed: %.3f s, %.2f positions/s\n", elapsed,
+			(double)positions / elapsed);
+	}
+
+	free(chunks[0].data);
+	free(chunks[1].data);
+	if (in != stdin)
+		fclose(in);
+	if (out != stdout)
+		fclose(out);
+
+	return (malformed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,437 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "nim.h"
+#include "nim_sg.h"
+#include "nim_tb.h"
+
+/*
+ * Tablebase generator.
+ *
+ * Exhaustively solves a Nim variant up to the given limits and
+ * writes the resulting tablebase (see include/nim_tb.h).
+ *
+ * With -c, instead, checks an existing standard misère Nim
+ * tablebase against the closed-form solver of the engine, and
+ * with -g, the Sprague-Grundy engine (see include/nim_sg.h) on an
+ * octal game against a brute-force mex: the values of every heap
+ * up to -m elements, which goes through the period found, if any,
+ * and the moves chosen for every position of up to -k heaps.
+ */
+
+/* Defaults. */
+#define DEFAULT_HEAPS 4
+#define DEFAULT_SIZE  7
+#define DEFAULT_FILE  "nim.tb"
+
+/**
+ * Show program usage.
+ */
+static void usage(const char *prg)
+{
+	fprintf(stderr,
+		"Usage: %s [options]\n"
+		"  -k heaps    max amount of non-empty heaps (default: %d)\n"
+		"  -m size     max heap size (default: %d)\n"
+		"  -t amounts  comma-separated amounts allowed to remove per\n"
+		"              move, from 1 to 64 (default: any amount)\n"
+		"  -n          normal play (last to move wins), instead of misère\n"
+		"  -o file     output file (default: %s)\n"
+		"  -c file     check a standard misère tablebase against the\n"
+		"              closed-form solver\n"
+		"  -g code     check the Sprague-Grundy engine on the octal game\n"
+		"              code (e.g: 0.77) against a brute-force mex\n",
+		prg, DEFAULT_HEAPS, DEFAULT_SIZE, DEFAULT_FILE);
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * Parse a comma-separated list of amounts into a take mask.
+ */
+static uint64_t parse_take_mask(const char *list, const char *prg)
+{
+	uint64_t mask;
+	unsigned long amount;
+	char *end;
+
+	mask = 0;
+	while (*list)
+	{
+		amount = strtoul(list, &end, 10);
+		if (end == list || amount < 1 || amount > 64)
+			usage(prg);
+		mask |= 1ULL << (amount - 1);
+
+		list = end;
+		if (*list == ',')
+			list++;
+	}
+	return (mask);
+}
+
+/**
+ * Check every position of @p tb against nim_is_winning() and
+ * the moves chosen by nim_best_move().
+ *
+ * Returns the amount of mismatches found.
+ */
+static uint64_t check(const struct nim_tb *tb)
+{
+	uint64_t heaps[NIM_TB_MAX_HEAPS] = {0};
+	struct nim_position pos;
+	struct nim_move move;
+	uint64_t mismatches;
+	uint64_t checked;
+	size_t i;
+	int win;
+
+	pos.heaps  = heaps;
+	pos.nheaps = tb->max_heaps;
+
+	mismatches = 0;
+	for (checked = 0; checked < tb->positions; checked++)
+	{
+		win = nim_tb_probe(tb, &pos);
+		if (win != nim_is_winning(&pos))
+		{
+			mismatches++;
+			printf("classification mismatch:");
+			for (i = 0; i < pos.nheaps; i++)
+				printf(" %" PRIu64, heaps[i]);
+			printf("\n");
+		}
+
+		/* A winning move must lead to a losing position. */
+		else if (win && !nim_best_move(&pos, &move))
+		{
+			heaps[move.heap] -= move.amount;
+			if (nim_tb_probe(tb, &pos))
+			{
+				mismatches++;
+				printf("bad move: heap %zu, amount %" PRIu64 "\n",
+					move.heap, move.amount);
+			}
+			heaps[move.heap] += move.amount;
+		}
+
+		/* Next canonical position. */
+		for (i = 0; i < pos.nheaps - 1 && heaps[i] == heaps[i + 1]; i++);
+		heaps[i]++;
+		while (i > 0)
+			heaps[--i] = 0;
+	}
+
+	printf("%" PRIu64 " positions checked, %" PRIu64 " mismatches\n",
+		checked, mismatches);
+	return (mismatches);
+}
+
+/**
+ * Compute the values of every heap of the octal game @p sg, up
+ * to @p size elements, the naive way: the mex of the values of
+ * all the options, every split included.
+ *
+ * Returns the values, or NULL if out of memory.
+ */
+static uint64_t *brute_force_values(const struct nim_sg *sg, uint64_t size)
+{
+	uint64_t *values;
+	uint8_t *seen;
+	size_t max;
+	uint64_t n;
+	uint64_t k;
+	uint64_t a;
+	uint64_t v;
+	int d;
+
+	/*
+	 * A heap has less than 'ndigits' options per element, so their
+	 * mex is below 'max': bigger values never change it.
+	 */
+	max    = sg->ndigits * (size + 1) + 1;
+	values = malloc((size + 1) * sizeof(*values));
+	seen   = malloc(max + 1);
+	if (!values || !seen)
+	{
+		free(values);
+		free(seen);
+		return (NULL);
+	}
+
+	for (n = 0; n <= size; n++)
+	{
+		memset(seen, 0, max + 1);
+		for (k = 1; k <= sg->ndigits && k <= n; k++)
+		{
+			d = sg->digits[k];
+			if ((d & 1) && n == k)
+				seen[0] = 1;
+			if ((d & 2) && n > k && values[n - k] < max)
+				seen[values[n - k]] = 1;
+			if (d & 4)
+				for (a = 1; a + k < n; a++)
+					if ((v = values[a] ^ values[n - k - a]) < max)
+						seen[v] = 1;
+		}
+		for (v = 0; seen[v]; v++);
+		values[n] = v;
+	}
+
+	free(seen);
+	return (values);
+}
+
+/**
+ * Returns 1 if the move @p m is legal in a heap of @p heap
+ * elements of the octal game @p sg, 0 otherwise.
+ */
+static int octal_legal(const struct nim_sg *sg, uint64_t heap,
+	const struct nim_sg_move *m)
+{
+	uint64_t right;
+	int d;
+
+	if (!m->amount || m->amount > sg->ndigits || m->amount > heap ||
+		m->left > heap - m->amount)
+	{
+		return (0);
+	}
+
+	d = sg->digits[m->amount];
+	right = heap - m->amount - m->left;
+
+	if (!m->left && !right)
+		return ((d & 1) != 0);
+	if (!m->left || !right)
+		return ((d & 2) != 0);
+	return ((d & 4) != 0);
+}
+
+/**
+ * Check the Sprague-Grundy engine on the octal game @p code
+ * against a brute-force mex: the values of the heaps up to
+ * @p size elements, and the best moves of every position with
+ * up to @p nheaps of them.
+ *
+ * Returns the amount of mismatches found, or -1 if the game
+ * is invalid or out of memory.
+ */
+static int64_t check_octal(const char *code, size_t nheaps, uint64_t size)
+{
+	uint64_t heaps[NIM_TB_MAX_HEAPS] = {0};
+	uint64_t scratch[NIM_TB_MAX_HEAPS];
+	struct nim_position pos;
+	struct nim_sg_move move;
+	struct nim_sg sg;
+	uint64_t *values;
+	uint64_t mismatches;
+	uint64_t checked;
+	uint64_t total;
+	uint64_t v;
+	uint64_t n;
+	size_t i;
+
+	if (nim_sg_init_octal(&sg, code, 0) < 0)
+		return (-1);
+
+	if (!(values = brute_force_values(&sg, size)))
+	{
+		nim_sg_free(&sg);
+		return (-1);
+	}
+
+	if (sg.period)
+		printf("%s: period %zu from heap %zu, %zu values computed\n", code,
+			sg.period, sg.preperiod, sg.count);
+	else
+	{
+		printf("%s: no period in the first %zu values\n", code, sg.count);
+		if (size >= sg.count)
+			size = sg.count - 1;
+	}
+
+	/* Heap values. */
+	mismatches = 0;
+	for (n = 0; n <= size; n++)
+	{
+		if (nim_sg_value(&sg, n, &v) < 0 || v != values[n])
+		{
+			mismatches++;
+			printf("value mismatch: heap %" PRIu64 ", brute force: %" PRIu64
+				"\n", n, values[n]);
+		}
+	}
+
+	/* Moves: a winning one must lead to a position of value 0. */
+	pos.heaps  = heaps;
+	pos.nheaps = nheaps;
+	for (checked = 0; heaps[nheaps - 1] <= size; checked++)
+	{
+		for (i = 0, total = 0; i < nheaps; i++)
+			total ^= values[heaps[i]];
+
+		if (!nim_sg_best_move(&sg, &pos, scratch, &move))
+		{
+			n = heaps[move.heap];
+			if (!octal_legal(&sg, n, &move) || (total && (total ^
+				values[n] ^ values[move.left] ^
+				values[n - move.amount - move.left])))
+			{
+				mismatches++;
+				printf("bad move: heap %zu, amount %" PRIu64 ", left %"
+					PRIu64 " in", move.heap, move.amount, move.left);
+				for (i = 0; i < nheaps; i++)
+					printf(" %" PRIu64, heaps[i]);
+				printf("\n");
+			}
+		}
+		else if (total)
+		{
+			mismatches++;
+			printf("no move found:");
+			for (i = 0; i < nheaps; i++)
+				printf(" %" PRIu64, heaps[i]);
+			printf("\n");
+		}
+
+		/* Next canonical position. */
+		for (i = 0; i < nheaps - 1 && heaps[i] == heaps[i + 1]; i++);
+		heaps[i]++;
+		while (i > 0)
+			heaps[--i] = 0;
+	}
+
+	printf("%" PRIu64 " heap values and %" PRIu64 " positions checked, %"
+		PRIu64 " mismatches\n", size + 1, checked, mismatches);
+
+	free(values);
+	nim_sg_free(&sg);
+	return ((int64_t)mismatches);
+}
+
+/**
+ * Main routine.
+ */
+int main(int argc, char **argv)
+{
+	struct nim_variant variant;
+	struct nim_tb tb;
+	const char *check_file;
+	const char *octal_code;
+	const char *out_file;
+	unsigned long heaps;
+	uint64_t size;
+	uint64_t mismatches;
+	int64_t octal_mismatches;
+	int c;
+
+	variant    = NIM_VARIANT_STANDARD;
+	heaps      = DEFAULT_HEAPS;
+	size       = DEFAULT_SIZE;
+	out_file   = DEFAULT_FILE;
+	check_file = NULL;
+	octal_code = NULL;
+
+	while ((c = getopt(argc, argv, "k:m:t:no:c:g:")) != -1)
+	{
+		switch (c)
+		{
+			case 'k':
+				heaps = strtoul(optarg, NULL, 10);
+				break;
+			case 'm':
+				size = strtoull(optarg, NULL, 10);
+				break;
+			case 't':
+				variant.take_mask = parse_take_mask(optarg, argv[0]);
+				break;
+			case 'n':
+				variant.misere = 0;
+				break;
+			case 'o':
+				out_file = optarg;
+				break;
+			case 'c':
+				check_file = optarg;
+				break;
+			case 'g':
+				octal_code = optarg;
+				break;
+			default:
+				usage(argv[0]);
+		}
+	}
+
+	if (check_file)
+	{
+		if (nim_tb_open(&tb, check_file) < 0)
+		{
+			fprintf(stderr, "Unable to open tablebase %s\n", check_file);
+			return (EXIT_FAILURE);
+		}
+		if (tb.variant.take_mask || !tb.variant.misere)
+		{
+			fprintf(stderr, "%s is not a standard misère tablebase\n",
+				check_file);
+			nim_tb_close(&tb);
+			return (EXIT_FAILURE);
+		}
+
+		mismatches = check(&tb);
+		nim_tb_close(&tb);
+		return (mismatches ? EXIT_FAILURE : EXIT_SUCCESS);
+	}
+
+	if (!heaps || heaps > NIM_TB_MAX_HEAPS)
+		usage(argv[0]);
+
+	if (octal_code)
+	{
+		octal_mismatches = check_octal(octal_code, heaps, size);
+		if (octal_mismatches < 0)
+		{
+			fprintf(stderr, "Invalid octal game %s (or out of memory)\n",
+				octal_code);
+			return (EXIT_FAILURE);
+		}
+		return (octal_mismatches ? EXIT_FAILURE : EXIT_SUCCESS);
+	}
+
+	if (nim_tb_generate(out_file, &variant, heaps, size) < 0)
+	{
+		fprintf(stderr, "Unable to generate tablebase %s (too big?)\n",
+			out_file);
+		return (EXIT_FAILURE);
+	}
+
+	printf("%s: %lu heaps of up to %" PRIu64 " elements, %s play\n",
+		out_file, heaps, size, variant.misere ? "misère" : "normal");
+	return (EXIT_SUCCESS);
+}
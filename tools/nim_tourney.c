@@ -0,0 +1,581 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "nim.h"
+#include "nim_mcts.h"
+#include "nim_rand.h"
+
+/*
+ * Self-play tournament runner.
+ *
+ * Plays games between two AI players (A and B) on random boards,
+ * generated just like the game does (1 up to per-row crystals on
+ * each row), or on the default board. Player A moves first in the
+ * even games and player B in the odd ones, so both first-mover
+ * choices are equally covered.
+ *
+ * Each game only depends on the seed and its index, so the results
+ * are the same whatever the amount of threads; except for the time
+ * budget players ('mcts:hard'), whose iterations per move depend on
+ * the machine load, and thus on the threads. Games are split in
+ * equal ranges among the workers, and idle workers steal half of
+ * the remaining range of the others.
+ */
+
+/* Defaults. */
+#define DEFAULT_GAMES 100000
+#define DEFAULT_SEED  1
+#define MAX_THREADS   256
+#define MAX_ROWS      4096
+#define GRAIN         64
+
+/* Latency histogram: 8 sub-buckets per power of two, in ns. */
+#define HIST_SUB      8
+#define HIST_BUCKETS  (16 + 60 * HIST_SUB)
+
+/* Players. */
+#define P_PERFECT 0
+#define P_RANDOM  1
+#define P_MCTS    2
+
+/*
+ * Player description.
+ */
+struct player
+{
+	const char *name;
+	int type;
+	int level;            /* MCTS level.                   */
+	uint64_t iterations;  /* MCTS iterations, if not 0.    */
+};
+
+/*
+ * Per-player statistics.
+ */
+struct stats
+{
+	uint64_t wins;
+	uint64_t wins_first;
+	uint64_t moves;
+	uint64_t forfeits;
+	uint64_t hist[HIST_BUCKETS];
+};
+
+/*
+ * Worker thread: its range of games, own players state and stats.
+ */
+struct worker
+{
+	pthread_t tid;
+	pthread_mutex_t mutex;
+	uint64_t lo;
+	uint64_t hi;
+	struct nim_mcts mcts[2];
+	uint64_t heaps[MAX_ROWS];
+	struct stats stats[2];
+	uint64_t games;
+	uint64_t stolen;
+};
+
+/* Options. */
+static struct player players[2];
+static uint64_t seed = DEFAULT_SEED;
+static int rows = 4;
+static int per_row = 7;
+static int random_board = 1;
+static int nthreads;
+
+static struct worker workers[MAX_THREADS];
+
+/* ---------------------------------------------------------------------- */
+/* Helpers.                                                               */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Abort with an error message.
+ */
+static void die(const char *msg)
+{
+	fprintf(stderr, "nim_tourney: %s\n", msg);
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * Returns the current monotonic time, in nanoseconds.
+ */
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+/**
+ * Histogram bucket of a latency of @p ns nanoseconds.
+ */
+static int hist_bucket(uint64_t ns)
+{
+	int e;
+
+	if (ns < 16)
+		return ((int)ns);
+
+	e = 63 - __builtin_clzll(ns);
+	return (16 + (e - 4) * HIST_SUB + (int)((ns >> (e - 3)) & (HIST_SUB - 1)));
+}
+
+/**
+ * Lower bound, in nanoseconds, of the histogram bucket @p b.
+ */
+static uint64_t hist_value(int b)
+{
+	int e;
+
+	if (b < 16)
+		return ((uint64_t)b);
+
+	e = 4 + (b - 16) / HIST_SUB;
+	return (((uint64_t)(HIST_SUB + (b - 16) % HIST_SUB)) << (e - 3));
+}
+
+/**
+ * Returns the @p p percentile (0-1) of the histogram @p hist with
+ * @p count samples, in nanoseconds.
+ */
+static uint64_t percentile(const uint64_t *hist, uint64_t count, double p)
+{
+	uint64_t target;
+	uint64_t acc;
+	int b;
+
+	target = (uint64_t)(p * (double)count);
+	if (target >= count)
+		target = count - 1;
+
+	for (acc = 0, b = 0; b < HIST_BUCKETS; b++)
+	{
+		acc += hist[b];
+		if (acc > target)
+			break;
+	}
+	return (hist_value(b < HIST_BUCKETS ? b : HIST_BUCKETS - 1));
+}
+
+/* ---------------------------------------------------------------------- */
+/* Players.                                                               */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Parse the player description @p desc into @p p.
+ *
+ * Returns 0 if success, -1 otherwise.
+ */
+static int parse_player(const char *desc, struct player *p)
+{
+	static const char *const levels[NIM_MCTS_LEVELS] = {
+		"easy", "medium", "hard"
+	};
+	char *end;
+	int i;
+
+	memset(p, 0, sizeof(*p));
+	p->name = desc;
+
+	if (!strcmp(desc, "perfect"))
+		p->type = P_PERFECT;
+	else if (!strcmp(desc, "random"))
+		p->type = P_RANDOM;
+	else if (!strncmp(desc, "mcts:", 5))
+	{
+		p->type = P_MCTS;
+		p->level = NIM_MCTS_HARD;
+		for (i = 0; i < NIM_MCTS_LEVELS; i++)
+			if (!strcmp(desc + 5, levels[i]))
+				break;
+
+		if (i < NIM_MCTS_LEVELS)
+			p->level = i;
+		else
+		{
+			p->iterations = strtoull(desc + 5, &end, 10);
+			if (!p->iterations || *end)
+				return (-1);
+		}
+	}
+	else
+		return (-1);
+
+	return (0);
+}
+
+/**
+ * Random player: a random non-empty heap and a random amount.
+ */
+static int random_move(const struct nim_position *pos, struct nim_move *move,
+	struct nim_rand *rng)
+{
+	size_t count;
+	size_t pick;
+	size_t i;
+
+	for (count = 0, i = 0; i < pos->nheaps; i++)
+		count += (pos->heaps[i] != 0);
+	if (!count)
+		return (-1);
+
+	pick = (size_t)nim_rand_range(rng, 0, count - 1);
+	for (i = 0; ; i++)
+		if (pos->heaps[i] && !pick--)
+			break;
+
+	move->heap   = i;
+	move->amount = nim_rand_range(rng, 1, pos->heaps[i]);
+	return (0);
+}
+
+/**
+ * Ask the player @p idx of worker @p w for a move.
+ */
+static int player_move(struct worker *w, int idx,
+	const struct nim_position *pos, struct nim_move *move, struct nim_rand *rng)
+{
+	switch (players[idx].type)
+	{
+		case P_PERFECT:
+			return (nim_best_move(pos, move));
+		case P_RANDOM:
+			return (random_move(pos, move, rng));
+		default:
+			return (nim_mcts_best_move(&w->mcts[idx], pos, move));
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+/* Games.                                                                 */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Play the game @p game in worker @p w.
+ */
+static void play(struct worker *w, uint64_t game)
+{
+	struct nim_position pos;
+	struct nim_move move;
+	struct nim_rand rng;
+	uint64_t start;
+	int first;
+	int cur;
+	int i;
+
+	nim_rand_seed(&rng, seed ^ (game * 0xD1B54A32D192ED03ULL));
+	for (i = 0; i < 2; i++)
+		nim_rand_seed(&w->mcts[i].rng, nim_rand_next(&rng));
+
+	/* Board, as setup_crystals_amount() does. */
+	if (random_board)
+		nim_rand_boards(&rng, w->heaps, 1, (size_t)rows, 1, (uint64_t)per_row);
+	else
+	{
+		for (i = 0; i < rows; i++)
+			w->heaps[i] = (uint64_t)((2 * i + 1) < per_row ? (2 * i + 1) :
+				per_row);
+	}
+
+	pos.heaps  = w->heaps;
+	pos.nheaps = (size_t)rows;
+	first = cur = (int)(game & 1);
+
+	for (;;)
+	{
+		start = now_ns();
+		if (player_move(w, cur, &pos, &move, &rng) < 0 ||
+			!nim_is_legal(&pos, &move))
+		{
+			w->stats[cur].forfeits++;
+			break;
+		}
+		w->stats[cur].hist[hist_bucket(now_ns() - start)]++;
+		w->stats[cur].moves++;
+
+		nim_apply_move(&pos, &move);
+
+		/* Misère: whoever takes the last crystal loses. */
+		if (nim_is_over(&pos))
+			break;
+		cur = !cur;
+	}
+
+	cur = !cur;
+	w->stats[cur].wins++;
+	w->stats[cur].wins_first += (cur == first);
+	w->games++;
+}
+
+/**
+ * Take the next batch of games for worker @p w, stealing from
+ * the other workers if its own range is over.
+ *
+ * Returns 1 if there is a batch in [@p lo, @p hi), 0 otherwise.
+ */
+static int next_batch(struct worker *w, uint64_t *lo, uint64_t *hi)
+{
+	struct worker *v;
+	uint64_t mid;
+	int i;
+
+	pthread_mutex_lock(&w->mutex);
+		*lo = w->lo;
+		*hi = w->lo + GRAIN < w->hi ? w->lo + GRAIN : w->hi;
+		w->lo = *hi;
+	pthread_mutex_unlock(&w->mutex);
+
+	if (*lo < *hi)
+		return (1);
+
+	/* Steal the upper half of someone else's range. */
+	for (i = 1; i < nthreads; i++)
+	{
+		v = &workers[((w - workers) + i) % nthreads];
+
+		pthread_mutex_lock(&v->mutex);
+			mid = v->lo + (v->hi - v->lo) / 2;
+			*lo = mid;
+			*hi = v->hi;
+			v->hi = mid;
+		pthread_mutex_unlock(&v->mutex);
+
+		if (*lo < *hi)
+		{
+			pthread_mutex_lock(&w->mutex);
+				w->lo = *lo;
+				w->hi = *hi;
+			pthread_mutex_unlock(&w->mutex);
+			w->stolen++;
+			return (next_batch(w, lo, hi));
+		}
+	}
+	return (0);
+}
+
+/**
+ * Worker thread routine.
+ */
+static void *worker_routine(void *arg)
+{
+	struct worker *w = arg;
+	uint64_t lo;
+	uint64_t hi;
+
+	while (next_batch(w, &lo, &hi))
+		for (; lo < hi; lo++)
+			play(w, lo);
+
+	return (NULL);
+}
+
+/* ---------------------------------------------------------------------- */
+/* Main.                                                                  */
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Show program usage and exit.
+ */
+static void usage(const char *prg)
+{
+	fprintf(stderr,
+		"Usage: %s [options] player-a player-b\n"
+		"Plays games between two players and reports the results.\n\n"
+		"Players:\n"
+		"  perfect       the game solver (computer_think)\n"
+		"  random        random moves\n"
+		"  mcts:LEVEL    MCTS, LEVEL is easy, medium, hard or an\n"
+		"                amount of iterations per move\n\n"
+		"Options:\n"
+		"  -g games      amount of games (default: %d)\n"
+		"  -r rows       rows per board (default: 4)\n"
+		"  -m max        max crystals per row (default: 7)\n"
+		"  -d            default board (1, 3, 5, 7...) instead of random\n"
+		"  -s seed       random seed (default: %d)\n"
+		"  -j threads    amount of worker threads (default: online CPUs)\n",
+		prg, DEFAULT_GAMES, DEFAULT_SEED);
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * Print the statistics of player @p idx.
+ */
+static void report(int idx, const struct stats *s, uint64_t games)
+{
+	double half = (double)games / 2.0;
+
+	printf("%c %-12s wins: %10" PRIu64 " (%6.2f%%), as first: %6.2f%%, "
+		"as second: %6.2f%%, forfeits: %" PRIu64 "\n",
+		'A' + idx, players[idx].name, s->wins,
+		100.0 * (double)s->wins / (double)games,
+		100.0 * (double)s->wins_first / half,
+		100.0 * (double)(s->wins - s->wins_first) / half,
+		s->forfeits);
+
+	if (!s->moves)
+		return;
+
+	printf("  latency per move (us): p50: %.2f, p90: %.2f, p99: %.2f, "
+		"p99.9: %.2f (%" PRIu64 " moves)\n",
+		percentile(s->hist, s->moves, 0.50)  / 1e3,
+		percentile(s->hist, s->moves, 0.90)  / 1e3,
+		percentile(s->hist, s->moves, 0.99)  / 1e3,
+		percentile(s->hist, s->moves, 0.999) / 1e3,
+		s->moves);
+}
+
+/**
+ * Main routine.
+ */
+int main(int argc, char **argv)
+{
+	struct stats total[2];
+	uint64_t games;
+	uint64_t stolen;
+	uint64_t start;
+	double elapsed;
+	int c;
+	int i;
+	int p;
+	int b;
+
+	games = DEFAULT_GAMES;
+	while ((c = getopt(argc, argv, "g:r:m:ds:j:")) != -1)
+	{
+		switch (c)
+		{
+			case 'g':
+				games = strtoull(optarg, NULL, 10);
+				break;
+			case 'r':
+				rows = atoi(optarg);
+				break;
+			case 'm':
+				per_row = atoi(optarg);
+				break;
+			case 'd':
+				random_board = 0;
+				break;
+			case 's':
+				seed = strtoull(optarg, NULL, 0);
+				break;
+			case 'j':
+				nthreads = atoi(optarg);
+				break;
+			default:
+				usage(argv[0]);
+		}
+	}
+
+	if (argc - optind != 2)
+		usage(argv[0]);
+
+	for (i = 0; i < 2; i++)
+		if (parse_player(argv[optind + i], &players[i]) < 0)
+			usage(argv[0]);
+
+	if (!nthreads)
+		nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (nthreads < 1 || nthreads > MAX_THREADS || !games ||
+		rows < 1 || rows > MAX_ROWS || per_row < 1)
+	{
+		usage(argv[0]);
+	}
+
+	/* Equal ranges, the stealing balances the rest. */
+	for (i = 0; i < nthreads; i++)
+	{
+		struct worker *w = &workers[i];
+
+		pthread_mutex_init(&w->mutex, NULL);
+		w->lo = games * (uint64_t)i / (uint64_t)nthreads;
+		w->hi = games * (uint64_t)(i + 1) / (uint64_t)nthreads;
+
+		for (p = 0; p < 2; p++)
+		{
+			if (players[p].type != P_MCTS)
+				continue;
+			if (nim_mcts_init(&w->mcts[p], 0, 1) < 0)
+				die("out of memory");
+
+			nim_mcts_set_level(&w->mcts[p], players[p].level);
+			if (players[p].iterations)
+			{
+				w->mcts[p].budget.iterations = players[p].iterations;
+				w->mcts[p].budget.seconds    = 0.0;
+			}
+		}
+	}
+
+	start = now_ns();
+	for (i = 0; i < nthreads; i++)
+		if (pthread_create(&workers[i].tid, NULL, worker_routine, &workers[i]))
+			die("unable to create worker threads");
+
+	memset(total, 0, sizeof(total));
+	games = stolen = 0;
+	for (i = 0; i < nthreads; i++)
+	{
+		pthread_join(workers[i].tid, NULL);
+		games  += workers[i].games;
+		stolen += workers[i].stolen;
+
+		for (p = 0; p < 2; p++)
+		{
+			total[p].wins       += workers[i].stats[p].wins;
+			total[p].wins_first += workers[i].stats[p].wins_first;
+			total[p].moves      += workers[i].stats[p].moves;
+			total[p].forfeits   += workers[i].stats[p].forfeits;
+			for (b = 0; b < HIST_BUCKETS; b++)
+				total[p].hist[b] += workers[i].stats[p].hist[b];
+
+			nim_mcts_free(&workers[i].mcts[p]);
+		}
+		pthread_mutex_destroy(&workers[i].mutex);
+	}
+	elapsed = (double)(now_ns() - start) * 1e-9;
+
+	printf("games: %" PRIu64 ", board: %d rows of %s%d, seed: %" PRIu64
+		", threads: %d (%" PRIu64 " steals)\n", games, rows,
+		random_board ? "1-" : "up to ", per_row, seed, nthreads, stolen);
+	printf("elapsed: %.3f s, %.2f games/s\n", elapsed,
+		(double)games / elapsed);
+
+	for (p = 0; p < 2; p++)
+		report(p, &total[p], games);
+
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,774 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* raylib's own copies, see $(RAYLIB_SRC)/external. */
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#define STBI_ONLY_JPEG
+#include "external/stb_image.h"
+#define SDEFL_IMPLEMENTATION
+#include "external/sdefl.h"
+
+/*
+ * Build-time resource embedder and texture pipeline.
+ *
+ * Turns the given files into a C source with their blobs and the
+ * res_entries[] table that describes them, see include/res.h, so
+ * that the game loads them from memory.
+ *
+ * PNG images are decoded here and stored as deflated RGBA8
+ * pixels (RES_PIXELS), ready to be inflated straight into a
+ * texture; '-m' adds the full mipmap chain. Other files (e.g: JPEG
+ * photos, which would grow dozens of times once decoded) are stored
+ * as is (RES_FILE).
+ *
+ * '-c codec' also stores a GPU compressed version of an (opaque)
+ * image, before the plain one, so that the loader tries it first:
+ * - dxt1: S3TC DXT1 (desktop and Web).
+ * - etc1: ETC1, which is also valid ETC2 RGB (Android).
+ * Compressed images are padded (by repeating the last row/column)
+ * to whole 4x4 blocks.
+ *
+ * Options apply to the next file only. Entries are named after
+ * the path given in the command line, e.g: "resources/atlas.png".
+ *
+ * Usage:
+ *   res_embed -o res_data.c [-m] [-c dxt1|etc1] file1...
+ */
+
+/* Same level raylib's CompressData() uses. */
+#define DEFLATE_LEVEL 8
+
+/* Bytes per line in the generated source. */
+#define BYTES_PER_LINE 16
+#define MAX_RES        64
+#define MAX_ENTRIES    (MAX_RES * 2)
+
+/* Texture codecs. */
+#define CODEC_NONE 0
+#define CODEC_DXT1 1
+#define CODEC_ETC1 2
+
+/*
+ * File to embed.
+ */
+static struct res
+{
+	const char *path;
+	int mipmaps;
+	int codec;
+} res[MAX_RES];
+static int nres;
+
+/*
+ * Generated entry, see struct res_entry.
+ */
+static struct entry
+{
+	const char *path;
+	const char *type;
+	const char *format;
+	int width;
+	int height;
+	int mipmaps;
+	int raw_size;
+} entries[MAX_ENTRIES];
+static int nentries;
+
+/* Deflate state, too big for the stack. */
+static struct sdefl sdefl;
+
+/* ETC1 modifier tables. */
+static const int etc1_tables[8][2] = {
+	{ 2,   8}, { 5,  17}, { 9,  29}, {13,  42},
+	{18,  60}, {24,  80}, {33, 106}, {47, 183}
+};
+
+/**
+ * Abort with an error message.
+ */
+static void die(const char *msg, const char *arg)
+{
+	fprintf(stderr, "res_embed: %s%s\n", msg, arg ? arg : "");
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * Returns true if @p path ends with @p ext (case insensitive).
+ */
+static int has_ext(const char *path, const char *ext)
+{
+	size_t lp = strlen(path);
+	size_t le = strlen(ext);
+	size_t i;
+
+	if (lp < le)
+		return (0);
+
+	for (i = 0; i < le; i++)
+		if ((path[lp - le + i] | 0x20) != ext[i])
+			return (0);
+	return (1);
+}
+
+/**
+ * Returns @p v clamped to 0-255.
+ */
+static int clamp255(int v)
+{
+	return (v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+/**
+ * Read the whole file @p path.
+ *
+ * Returns its contents, and its size in @p size.
+ */
+static unsigned char *read_file(const char *path, int *size)
+{
+	unsigned char *buf;
+	long len;
+	FILE *f;
+
+	if (!(f = fopen(path, "rb")))
+		die("unable to open ", path);
+
+	if (fseek(f, 0, SEEK_END) || (len = ftell(f)) < 0 ||
+		fseek(f, 0, SEEK_SET))
+	{
+		die("unable to read ", path);
+	}
+
+	if (!(buf = malloc(len ? len : 1)))
+		die("out of memory", NULL);
+
+	if (fread(buf, 1, len, f) != (size_t)len)
+		die("unable to read ", path);
+
+	fclose(f);
+	*size = (int)len;
+	return (buf);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Mipmaps                                                                   */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Build the mipmap chain of the @p w x @p h RGBA image @p rgba,
+ * down to 1x1: 2x2 box filter, with the colors weighted by their
+ * alpha, so that transparent texels do not darken the edges.
+ *
+ * Returns all the levels, one after another, the level count in
+ * @p levels and the total size in @p size.
+ */
+static unsigned char *build_mipmaps(const unsigned char *rgba, int w, int h,
+	int *levels, int *size)
+{
+	const unsigned char *src;
+	unsigned char *chain;
+	unsigned char *dst;
+	int sw, sh, dw, dh;
+	int x, y, c, i;
+	int sum[4];
+	int total;
+
+	total = 0;
+	for (dw = w, dh = h, *levels = 1; ; (*levels)++)
+	{
+		total += dw * dh * 4;
+		if (dw == 1 && dh == 1)
+			break;
+		dw = dw > 1 ? dw >> 1 : 1;
+		dh = dh > 1 ? dh >> 1 : 1;
+	}
+
+	if (!(chain = malloc(total)))
+		die("out of memory", NULL);
+	memcpy(chain, rgba, (size_t)w * h * 4);
+
+	src = chain;
+	sw  = w;
+	sh  = h;
+	for (i = 1; i < *levels; i++)
+	{
+		dst = (unsigned char *)src + sw * sh * 4;
+		dw  = sw > 1 ? sw >> 1 : 1;
+		dh  = sh > 1 ? sh >> 1 : 1;
+
+		for (y = 0; y < dh; y++)
+		{
+			for (x = 0; x < dw; x++)
+			{
+				const unsigned char *p[4];
+				/* 1 texel wide/tall sources: same row/column twice. */
+				int x0 = x*2, x1 = x*2 + 1 < sw ? x*2 + 1 : x*2;
+				int y0 = y*2, y1 = y*2 + 1 < sh ? y*2 + 1 : y*2;
+
+				p[0] = &src[(y0 * sw + x0) * 4];
+				p[1] = &src[(y0 * sw + x1) * 4];
+				p[2] = &src[(y1 * sw + x0) * 4];
+				p[3] = &src[(y1 * sw + x1) * 4];
+
+				memset(sum, 0, sizeof(sum));
+				for (c = 0; c < 4; c++)
+				{
+					sum[0] += p[c][0] * p[c][3];
+					sum[1] += p[c][1] * p[c][3];
+					sum[2] += p[c][2] * p[c][3];
+					sum[3] += p[c][3];
+				}
+
+				for (c = 0; c < 3; c++)
+				{
+					dst[(y*dw + x)*4 + c] = sum[3] ?
+						(unsigned char)((sum[c] + sum[3]/2) / sum[3]) : 0;
+				}
+				dst[(y*dw + x)*4 + 3] = (unsigned char)((sum[3] + 2) / 4);
+			}
+		}
+
+		src = dst;
+		sw  = dw;
+		sh  = dh;
+	}
+
+	*size = total;
+	return (chain);
+}
+
+/* ------------------------------------------------------------------------- */
+/* DXT1                                                                      */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Returns the RGB565 color nearest to (@p r, @p g, @p b).
+ */
+static unsigned to_565(int r, int g, int b)
+{
+	return (((r * 31 + 127) / 255) << 11) | (((g * 63 + 127) / 255) << 5) |
+		((b * 31 + 127) / 255);
+}
+
+/**
+ * Expand the RGB565 color @p c into @p rgb.
+ */
+static void from_565(unsigned c, int *rgb)
+{
+	rgb[0] = ((c >> 11) & 31) << 3 | ((c >> 11) & 31) >> 2;
+	rgb[1] = ((c >>  5) & 63) << 2 | ((c >>  5) & 63) >> 4;
+	rgb[2] = ( c        & 31) << 3 | ( c        & 31) >> 2;
+}
+
+/**
+ * Encode the 4x4 RGBA block @p px (row major) as DXT1 (4 colors
+ * mode), into the 8 bytes at @p out.
+ *
+ * The endpoints are the corners of the (slightly inset) color
+ * bounding box.
+ */
+static void dxt1_block(const unsigned char *px, unsigned char *out)
+{
+	int lo[3] = {255, 255, 255};
+	int hi[3] = {0, 0, 0};
+	int pal[4][3];
+	unsigned c0, c1, t;
+	unsigned long bits;
+	int best, err, e;
+	int i, j, c, d;
+
+	for (i = 0; i < 16; i++)
+	{
+		for (c = 0; c < 3; c++)
+		{
+			if (px[i*4 + c] < lo[c]) lo[c] = px[i*4 + c];
+			if (px[i*4 + c] > hi[c]) hi[c] = px[i*4 + c];
+		}
+	}
+
+	for (c = 0; c < 3; c++)
+	{
+		d      = (hi[c] - lo[c]) >> 4;
+		lo[c] += d;
+		hi[c] -= d;
+	}
+
+	c0 = to_565(hi[0], hi[1], hi[2]);
+	c1 = to_565(lo[0], lo[1], lo[2]);
+	if (c0 < c1)
+	{
+		t  = c0;
+		c0 = c1;
+		c1 = t;
+	}
+
+	from_565(c0, pal[0]);
+	from_565(c1, pal[1]);
+	for (c = 0; c < 3; c++)
+	{
+		pal[2][c] = (2*pal[0][c] + pal[1][c]) / 3;
+		pal[3][c] = (pal[0][c] + 2*pal[1][c]) / 3;
+	}
+
+	/* Same endpoints: 3 colors mode, everything is color 0. */
+	bits = 0;
+	for (i = 0; c0 != c1 && i < 16; i++)
+	{
+		best = 0;
+		err  = 1 << 30;
+		for (j = 0; j < 4; j++)
+		{
+			for (c = 0, e = 0; c < 3; c++)
+				e += (px[i*4 + c] - pal[j][c]) * (px[i*4 + c] - pal[j][c]);
+			if (e < err)
+			{
+				err  = e;
+				best = j;
+			}
+		}
+		bits |= (unsigned long)best << (2*i);
+	}
+
+	out[0] = c0 & 0xFF;
+	out[1] = c0 >> 8;
+	out[2] = c1 & 0xFF;
+	out[3] = c1 >> 8;
+	out[4] = bits & 0xFF;
+	out[5] = (bits >>  8) & 0xFF;
+	out[6] = (bits >> 16) & 0xFF;
+	out[7] = (bits >> 24) & 0xFF;
+}
+
+/* ------------------------------------------------------------------------- */
+/* ETC1                                                                      */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Find the best modifier table for the pixels of the 4x4 RGBA
+ * block @p px that belong to @p sub (see etc1_block()), around the
+ * @p base color.
+ *
+ * Returns the error, the table in @p table and the pixel indices
+ * in @p idx.
+ */
+static long etc1_subblock(const unsigned char *px, int flip, int sub,
+	const int *base, int *table, int *idx)
+{
+	int cur[16];
+	long best_err;
+	long err;
+	int m, best_m, e, me;
+	int mod;
+	int t, i, c;
+
+	best_err = -1;
+	for (t = 0; t < 8; t++)
+	{
+		err = 0;
+		for (i = 0; i < 16; i++)
+		{
+			/* Pixel (x, y) = (i % 4, i / 4). */
+			if ((flip ? (i / 4) >= 2 : (i % 4) >= 2) != sub)
+				continue;
+
+			best_m = 0;
+			me     = 1 << 30;
+			for (m = 0; m < 4; m++)
+			{
+				mod = etc1_tables[t][m & 1] * (m & 2 ? -1 : 1);
+				for (c = 0, e = 0; c < 3; c++)
+				{
+					int d = px[i*4 + c] - clamp255(base[c] + mod);
+					e += d * d;
+				}
+				if (e < me)
+				{
+					me     = e;
+					best_m = m;
+				}
+			}
+			cur[i] = best_m;
+			err   += me;
+		}
+
+		if (best_err < 0 || err < best_err)
+		{
+			best_err = err;
+			*table   = t;
+			for (i = 0; i < 16; i++)
+				if ((flip ? (i / 4) >= 2 : (i % 4) >= 2) == sub)
+					idx[i] = cur[i];
+		}
+	}
+
+	return (best_err);
+}
+
+/**
+ * Encode the 4x4 RGBA block @p px (row major) as ETC1, into the
+ * 8 bytes at @p out.
+ *
+ * Tries both subblock layouts (flip) and both base color modes
+ * (individual 4:4:4 and differential 5:5:5), with the subblock
+ * averages as base colors, and keeps the best.
+ */
+static void etc1_block(const unsigned char *px, unsigned char *out)
+{
+	unsigned long hi, lo;
+	unsigned long best_hi = 0, best_lo = 0;
+	long best_err = -1;
+	int q[2][3], base[2][3];
+	int avg[2][3];
+	int table[2];
+	int idx[16];
+	long err;
+	int flip, diff, sub;
+	int i, c;
+
+	for (flip = 0; flip < 2; flip++)
+	{
+		memset(avg, 0, sizeof(avg));
+		for (i = 0; i < 16; i++)
+		{
+			sub = flip ? (i / 4) >= 2 : (i % 4) >= 2;
+			for (c = 0; c < 3; c++)
+				avg[sub][c] += px[i*4 + c];
+		}
+
+		for (diff = 0; diff < 2; diff++)
+		{
+			for (sub = 0; sub < 2; sub++)
+			{
+				for (c = 0; c < 3; c++)
+				{
+					if (diff)
+					{
+						q[sub][c]    = (avg[sub][c] * 31 + 255*4) / (255*8);
+						base[sub][c] = q[sub][c] << 3 | q[sub][c] >> 2;
+					}
+					else
+					{
+						q[sub][c]    = (avg[sub][c] * 15 + 255*4) / (255*8);
+						base[sub][c] = q[sub][c] << 4 | q[sub][c];
+					}
+				}
+			}
+
+			/* Differential: the delta must fit in 3 bits. */
+			if (diff)
+			{
+				for (c = 0; c < 3; c++)
+					if (q[1][c] - q[0][c] < -4 || q[1][c] - q[0][c] > 3)
+						break;
+				if (c < 3)
+					continue;
+			}
+
+			err  = etc1_subblock(px, flip, 0, base[0], &table[0], idx);
+			err += etc1_subblock(px, flip, 1, base[1], &table[1], idx);
+			if (best_err >= 0 && err >= best_err)
+				continue;
+
+			if (diff)
+			{
+				hi = (unsigned long)q[0][0] << 27 |
+					(unsigned long)((q[1][0] - q[0][0]) & 7) << 24 |
+					(unsigned long)q[0][1] << 19 |
+					(unsigned long)((q[1][1] - q[0][1]) & 7) << 16 |
+					(unsigned long)q[0][2] << 11 |
+					(unsigned long)((q[1][2] - q[0][2]) & 7) << 8;
+			}
+			else
+			{
+				hi = (unsigned long)q[0][0] << 28 |
+					(unsigned long)q[1][0] << 24 |
+					(unsigned long)q[0][1] << 20 |
+					(unsigned long)q[1][1] << 16 |
+					(unsigned long)q[0][2] << 12 |
+					(unsigned long)q[1][2] << 8;
+			}
+			hi |= (unsigned long)table[0] << 5 | (unsigned long)table[1] << 2 |
+				(unsigned long)diff << 1 | (unsigned long)flip;
+
+			/* Indices: column major, MSBs then LSBs. */
+			lo = 0;
+			for (i = 0; i < 16; i++)
+			{
+				int bit = (i % 4) * 4 + i / 4;
+				lo |= (unsigned long)(idx[i] >> 1) << (16 + bit);
+				lo |= (unsigned long)(idx[i] & 1) << bit;
+			}
+
+			best_err = err;
+			best_hi  = hi;
+			best_lo  = lo;
+		}
+	}
+
+	for (i = 0; i < 4; i++)
+	{
+		out[i]     = (best_hi >> (24 - 8*i)) & 0xFF;
+		out[i + 4] = (best_lo >> (24 - 8*i)) & 0xFF;
+	}
+}
+
+/**
+ * Compress the @p w x @p h RGBA image @p rgba with @p codec,
+ * padded to whole 4x4 blocks (new size in @p pw x @p ph).
+ *
+ * Returns the blocks, and their size in @p size.
+ */
+static unsigned char *encode_blocks(int codec, const unsigned char *rgba, int w,
+	int h, int *pw, int *ph, int *size)
+{
+	unsigned char block[16 * 4];
+	unsigned char *out;
+	int bx, by;
+	int x, y;
+	int sx, sy;
+
+	*pw   = (w + 3) & ~3;
+	*ph   = (h + 3) & ~3;
+	*size = (*pw / 4) * (*ph / 4) * 8;
+
+	if (!(out = malloc(*size)))
+		die("out of memory", NULL);
+
+	for (by = 0; by < *ph / 4; by++)
+	{
+		for (bx = 0; bx < *pw / 4; bx++)
+		{
+			for (y = 0; y < 4; y++)
+			{
+				for (x = 0; x < 4; x++)
+				{
+					sx = bx*4 + x < w ? bx*4 + x : w - 1;
+					sy = by*4 + y < h ? by*4 + y : h - 1;
+					memcpy(&block[(y*4 + x) * 4], &rgba[(sy*w + sx) * 4], 4);
+				}
+			}
+
+			if (codec == CODEC_DXT1)
+				dxt1_block(block, &out[(by * (*pw / 4) + bx) * 8]);
+			else
+				etc1_block(block, &out[(by * (*pw / 4) + bx) * 8]);
+		}
+	}
+
+	return (out);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Output                                                                    */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Write @p size bytes of @p data as the blob of the entry @p e
+ * (deflated, for RES_PIXELS) and add it to the table.
+ */
+static void write_entry(FILE *f, const struct entry *e,
+	const unsigned char *data, int size)
+{
+	unsigned char *def;
+	int i;
+
+	if (nentries == MAX_ENTRIES)
+		die("too many entries", NULL);
+	entries[nentries] = *e;
+
+	def = NULL;
+	if (!strcmp(e->type, "RES_PIXELS"))
+	{
+		if (!(def = malloc(sdefl_bound(size))))
+			die("out of memory", NULL);
+		size = sdeflate(&sdefl, def, data, size, DEFLATE_LEVEL);
+		data = def;
+	}
+
+	fprintf(f, "static const unsigned char res_blob_%d[] = {", nentries);
+	for (i = 0; i < size; i++)
+	{
+		if (!(i % BYTES_PER_LINE))
+			fprintf(f, "\n\t");
+		fprintf(f, "0x%02x,%s", data[i],
+			(i + 1) % BYTES_PER_LINE && i + 1 < size ? " " : "");
+	}
+	fprintf(f, "\n};\n\n");
+
+	free(def);
+	nentries++;
+}
+
+/**
+ * Embed the file @p r.
+ */
+static void embed(FILE *f, const struct res *r)
+{
+	struct entry e = {0};
+	unsigned char *rgba;
+	unsigned char *data;
+	int comp;
+	int size;
+
+	e.path = r->path;
+	rgba   = NULL;
+
+	if (has_ext(r->path, ".png") || r->codec != CODEC_NONE)
+	{
+		rgba = stbi_load(r->path, &e.width, &e.height, &comp, 4);
+		if (!rgba)
+			die("unable to decode ", r->path);
+	}
+
+	/* Compressed version first. */
+	if (r->codec != CODEC_NONE)
+	{
+		struct entry c = e;
+
+		data = encode_blocks(r->codec, rgba, e.width, e.height, &c.width,
+			&c.height, &size);
+
+		c.type     = "RES_PIXELS";
+		c.format   = r->codec == CODEC_DXT1 ?
+			"PIXELFORMAT_COMPRESSED_DXT1_RGB" :
+			"PIXELFORMAT_COMPRESSED_ETC1_RGB";
+		c.mipmaps  = 1;
+		c.raw_size = size;
+		write_entry(f, &c, data, size);
+		free(data);
+	}
+
+	if (has_ext(r->path, ".png"))
+	{
+		e.type   = "RES_PIXELS";
+		e.format = "PIXELFORMAT_UNCOMPRESSED_R8G8B8A8";
+
+		if (r->mipmaps)
+			data = build_mipmaps(rgba, e.width, e.height, &e.mipmaps, &size);
+		else
+		{
+			data      = rgba;
+			size      = e.width * e.height * 4;
+			e.mipmaps = 1;
+		}
+
+		e.raw_size = size;
+		write_entry(f, &e, data, size);
+		if (data != rgba)
+			free(data);
+	}
+	else
+	{
+		data = read_file(r->path, &size);
+
+		e.type   = "RES_FILE";
+		e.format = "0";
+		e.width  = e.height = 0;
+		write_entry(f, &e, data, size);
+		free(data);
+	}
+
+	stbi_image_free(rgba);
+}
+
+/**
+ * Main routine.
+ */
+int main(int argc, char **argv)
+{
+	const char *out;
+	int mipmaps;
+	int codec;
+	FILE *f;
+	int i;
+
+	out     = NULL;
+	mipmaps = 0;
+	codec   = CODEC_NONE;
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-o") && i + 1 < argc)
+			out = argv[++i];
+		else if (!strcmp(argv[i], "-m"))
+			mipmaps = 1;
+		else if (!strcmp(argv[i], "-c") && i + 1 < argc)
+		{
+			i++;
+			if (!strcmp(argv[i], "dxt1"))
+				codec = CODEC_DXT1;
+			else if (!strcmp(argv[i], "etc1"))
+				codec = CODEC_ETC1;
+			else if (strcmp(argv[i], "none"))
+				die("unknown codec: ", argv[i]);
+		}
+		else if (nres == MAX_RES)
+			die("too many files", NULL);
+		else
+		{
+			res[nres].path    = argv[i];
+			res[nres].mipmaps = mipmaps;
+			res[nres].codec   = codec;
+			nres++;
+			mipmaps = 0;
+			codec   = CODEC_NONE;
+		}
+	}
+
+	if (!out || !nres)
+	{
+		fprintf(stderr, "Usage: %s -o res_data.c [-m] [-c dxt1|etc1] "
+			"files...\n", argv[0]);
+		return (EXIT_FAILURE);
+	}
+
+	if (!(f = fopen(out, "w")))
+		die("unable to create ", out);
+
+	fprintf(f,
+		"/* Generated by tools/res_embed.c, do not edit. */\n\n"
+		"#include <stddef.h>\n"
+		"#include \"res.h\"\n\n");
+
+	for (i = 0; i < nres; i++)
+		embed(f, &res[i]);
+
+	fprintf(f, "const struct res_entry res_entries[] = {\n");
+	for (i = 0; i < nentries; i++)
+	{
+		fprintf(f, "\t{\"%s\", %s, %s, %d, %d, %d, %d,\n"
+			"\t\tres_blob_%d, sizeof(res_blob_%d)},\n", entries[i].path,
+			entries[i].type, entries[i].format, entries[i].width,
+			entries[i].height, entries[i].mipmaps, entries[i].raw_size, i, i);
+	}
+	fprintf(f, "};\n\nconst int res_count = %d;\n", nentries);
+
+	if (fclose(f))
+		die("unable to write ", out);
+
+	return (EXIT_SUCCESS);
+}